@@ -0,0 +1,658 @@
+#include "batch_evaluator.h"
+
+#include <util/arith_tools.h>
+#include <util/std_expr.h>
+#include <util/std_types.h>
+
+#include <algorithm>
+
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define FASTSYNTH_SIMD
+#include <immintrin.h>
+#endif
+
+#ifdef FASTSYNTH_SIMD
+
+/// Lane-wise operations on vectors of 64-bit lanes, compiled for
+/// AVX-512 whatever the build targets. Comparisons yield 0 or 1 per lane.
+namespace avx512
+{
+#define FASTSYNTH_TARGET __attribute__((target("avx512f")))
+
+const std::size_t lanes = 8;
+using vect = __m512i;
+
+FASTSYNTH_TARGET inline vect load(const std::uint64_t *p)
+{
+  return _mm512_loadu_si512(p);
+}
+
+FASTSYNTH_TARGET inline void store(std::uint64_t *p, vect v)
+{
+  _mm512_storeu_si512(p, v);
+}
+
+FASTSYNTH_TARGET inline vect set1(std::uint64_t x)
+{
+  return _mm512_set1_epi64(static_cast<long long>(x));
+}
+
+FASTSYNTH_TARGET inline vect add(vect a, vect b)
+{
+  return _mm512_add_epi64(a, b);
+}
+
+FASTSYNTH_TARGET inline vect sub(vect a, vect b)
+{
+  return _mm512_sub_epi64(a, b);
+}
+
+FASTSYNTH_TARGET inline vect bitand_(vect a, vect b)
+{
+  return _mm512_and_si512(a, b);
+}
+
+FASTSYNTH_TARGET inline vect bitor_(vect a, vect b)
+{
+  return _mm512_or_si512(a, b);
+}
+
+FASTSYNTH_TARGET inline vect bitxor_(vect a, vect b)
+{
+  return _mm512_xor_si512(a, b);
+}
+
+FASTSYNTH_TARGET inline vect shl(vect a, vect b)
+{
+  return _mm512_sllv_epi64(a, b);
+}
+
+FASTSYNTH_TARGET inline vect lshr(vect a, vect b)
+{
+  return _mm512_srlv_epi64(a, b);
+}
+
+/// Zeroes the lanes of \p r where \p b is greater than \p limit.
+FASTSYNTH_TARGET inline vect zero_if_above(vect r, vect b, std::uint64_t limit)
+{
+  return _mm512_maskz_mov_epi64(
+      _mm512_cmple_epu64_mask(b, set1(limit)), r);
+}
+
+FASTSYNTH_TARGET inline vect eq(vect a, vect b)
+{
+  return _mm512_maskz_set1_epi64(_mm512_cmpeq_epi64_mask(a, b), 1);
+}
+
+FASTSYNTH_TARGET inline vect ult(vect a, vect b)
+{
+  return _mm512_maskz_set1_epi64(_mm512_cmplt_epu64_mask(a, b), 1);
+}
+
+FASTSYNTH_TARGET inline vect slt(vect a, vect b)
+{
+  return _mm512_maskz_set1_epi64(_mm512_cmplt_epi64_mask(a, b), 1);
+}
+
+#include "batch_kernel.inc"
+
+#undef FASTSYNTH_TARGET
+} // namespace avx512
+
+/// As avx512, for AVX2.
+namespace avx2
+{
+#define FASTSYNTH_TARGET __attribute__((target("avx2")))
+
+const std::size_t lanes = 4;
+using vect = __m256i;
+
+FASTSYNTH_TARGET inline vect load(const std::uint64_t *p)
+{
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+}
+
+FASTSYNTH_TARGET inline void store(std::uint64_t *p, vect v)
+{
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), v);
+}
+
+FASTSYNTH_TARGET inline vect set1(std::uint64_t x)
+{
+  return _mm256_set1_epi64x(static_cast<long long>(x));
+}
+
+FASTSYNTH_TARGET inline vect add(vect a, vect b)
+{
+  return _mm256_add_epi64(a, b);
+}
+
+FASTSYNTH_TARGET inline vect sub(vect a, vect b)
+{
+  return _mm256_sub_epi64(a, b);
+}
+
+FASTSYNTH_TARGET inline vect bitand_(vect a, vect b)
+{
+  return _mm256_and_si256(a, b);
+}
+
+FASTSYNTH_TARGET inline vect bitor_(vect a, vect b)
+{
+  return _mm256_or_si256(a, b);
+}
+
+FASTSYNTH_TARGET inline vect bitxor_(vect a, vect b)
+{
+  return _mm256_xor_si256(a, b);
+}
+
+FASTSYNTH_TARGET inline vect shl(vect a, vect b)
+{
+  return _mm256_sllv_epi64(a, b);
+}
+
+FASTSYNTH_TARGET inline vect lshr(vect a, vect b)
+{
+  return _mm256_srlv_epi64(a, b);
+}
+
+/// Zeroes the lanes of \p r where \p b is greater than \p limit.
+/// There is no unsigned comparison; \p b must be below 2^63.
+FASTSYNTH_TARGET inline vect zero_if_above(vect r, vect b, std::uint64_t limit)
+{
+  return _mm256_andnot_si256(_mm256_cmpgt_epi64(b, set1(limit)), r);
+}
+
+FASTSYNTH_TARGET inline vect eq(vect a, vect b)
+{
+  return _mm256_and_si256(_mm256_cmpeq_epi64(a, b), set1(1));
+}
+
+FASTSYNTH_TARGET inline vect slt(vect a, vect b)
+{
+  return _mm256_and_si256(_mm256_cmpgt_epi64(b, a), set1(1));
+}
+
+FASTSYNTH_TARGET inline vect ult(vect a, vect b)
+{
+  const vect flip = set1(std::uint64_t(1) << 63);
+  return slt(bitxor_(a, flip), bitxor_(b, flip));
+}
+
+#include "batch_kernel.inc"
+
+#undef FASTSYNTH_TARGET
+} // namespace avx2
+
+using vector_kernelt = std::size_t (*)(
+    batch_evaluatort::opcodet,
+    std::size_t,
+    std::size_t,
+    std::uint64_t *,
+    const std::uint64_t *,
+    const std::uint64_t *,
+    std::size_t);
+
+/// The widest kernel the processor supports, or none.
+static vector_kernelt select_vector_kernel()
+{
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx512f"))
+    return avx512::execute;
+  else if (__builtin_cpu_supports("avx2"))
+    return avx2::execute;
+  else
+    return nullptr;
+}
+
+#endif
+
+const std::size_t batch_evaluatort::block_size;
+
+static std::uint64_t mask(std::size_t width)
+{
+  return width >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << width) - 1;
+}
+
+/// Sign-extends the lower \p width bits to 64 bits.
+static std::uint64_t sign_extend(std::uint64_t value, std::size_t width)
+{
+  const std::uint64_t sign = std::uint64_t(1) << (width - 1);
+  return ((value & mask(width)) ^ sign) - sign;
+}
+
+static std::size_t width_of(const typet &type)
+{
+  if (type.id() == ID_bool)
+    return 1;
+
+  return to_bitvector_type(type).get_width();
+}
+
+bool batch_evaluatort::is_supported(const typet &type)
+{
+  if (type.id() == ID_bool)
+    return true;
+
+  if (type.id() == ID_unsignedbv || type.id() == ID_signedbv)
+  {
+    const std::size_t width = to_bitvector_type(type).get_width();
+    return width >= 1 && width <= 64;
+  }
+
+  return false;
+}
+
+std::uint64_t batch_evaluatort::to_lane(const exprt &expr)
+{
+  if (expr.type().id() == ID_bool)
+    return expr.is_true() ? 1 : 0;
+
+  mp_integer value;
+  if (to_integer(to_constant_expr(expr), value))
+    return 0;
+
+  const std::size_t width = width_of(expr.type());
+
+  if (value.is_negative())
+    value += power(2, width);
+
+  return numeric_cast_v<std::uint64_t>(value) & mask(width);
+}
+
+exprt batch_evaluatort::from_lane(std::uint64_t lane, const typet &type)
+{
+  if (type.id() == ID_bool)
+  {
+    if (lane != 0)
+      return true_exprt();
+    else
+      return false_exprt();
+  }
+
+  const std::size_t width = width_of(type);
+  lane &= mask(width);
+
+  mp_integer value(static_cast<mp_integer::ullong_t>(lane));
+
+  if (type.id() == ID_signedbv && (lane >> (width - 1)) != 0)
+    value -= power(2, width);
+
+  return from_integer(value, type);
+}
+
+std::size_t batch_evaluatort::add_instruction(
+    opcodet opcode,
+    std::size_t width,
+    std::size_t operand_width,
+    std::size_t op0,
+    std::size_t op1,
+    std::size_t op2,
+    std::uint64_t constant)
+{
+  instructiont instruction;
+  instruction.opcode = opcode;
+  instruction.width = width;
+  instruction.operand_width = operand_width;
+  instruction.op0 = op0;
+  instruction.op1 = op1;
+  instruction.op2 = op2;
+  instruction.constant = constant;
+  program.push_back(instruction);
+  return program.size() - 1;
+}
+
+bool batch_evaluatort::compile(
+    const exprt &expr,
+    const std::vector<exprt> &variables)
+{
+  program.clear();
+  compiledt compiled;
+
+  for (std::size_t i = 0; i < variables.size(); i++)
+  {
+    if (!is_supported(variables[i].type()))
+      return false;
+
+    const std::size_t width = width_of(variables[i].type());
+    compiled[variables[i]] =
+        add_instruction(opcodet::INPUT, width, width, 0, 0, 0, i);
+  }
+
+  if (!compile_rec(expr, compiled, result_register))
+  {
+    program.clear();
+    return false;
+  }
+
+  return true;
+}
+
+bool batch_evaluatort::compile_rec(
+    const exprt &expr,
+    compiledt &compiled,
+    std::size_t &result)
+{
+  const auto entry = compiled.find(expr);
+
+  if (entry != compiled.end())
+  {
+    result = entry->second;
+    return true;
+  }
+
+  if (!is_supported(expr.type()))
+    return false;
+
+  const std::size_t width = width_of(expr.type());
+  const irep_idt &id = expr.id();
+
+  if (id == ID_constant)
+  {
+    result = add_instruction(
+        opcodet::CONSTANT, width, width, 0, 0, 0, to_lane(expr));
+    compiled[expr] = result;
+    return true;
+  }
+
+  // symbols must be among the variables
+  if (expr.operands().empty())
+    return false;
+
+  std::vector<std::size_t> ops;
+  ops.reserve(expr.operands().size());
+
+  for (const auto &op : expr.operands())
+  {
+    if (!is_supported(op.type()))
+      return false;
+
+    std::size_t index;
+    if (!compile_rec(op, compiled, index))
+      return false;
+    ops.push_back(index);
+  }
+
+  const std::size_t operand_width = width_of(expr.operands()[0].type());
+  const bool is_signed = expr.operands()[0].type().id() == ID_signedbv;
+
+  // operators with any number of operands
+  opcodet multi;
+  bool is_multi = true;
+
+  if (id == ID_plus)
+    multi = opcodet::ADD;
+  else if (id == ID_mult)
+    multi = opcodet::MUL;
+  else if (id == ID_bitand || id == ID_and)
+    multi = opcodet::AND;
+  else if (id == ID_bitor || id == ID_or)
+    multi = opcodet::OR;
+  else if (id == ID_bitxor || id == ID_xor)
+    multi = opcodet::XOR;
+  else
+    is_multi = false;
+
+  if (is_multi)
+  {
+    result = ops[0];
+    for (std::size_t i = 1; i < ops.size(); i++)
+      result = add_instruction(multi, width, width, result, ops[i]);
+  }
+  else if (ops.size() == 1)
+  {
+    if (id == ID_bitnot || id == ID_not)
+      result = add_instruction(opcodet::NOT, width, width, ops[0]);
+    else if (id == ID_unary_minus)
+      result = add_instruction(opcodet::NEG, width, width, ops[0]);
+    else if (id == ID_typecast)
+    {
+      if (expr.type().id() == ID_bool)
+        result = add_instruction(
+            opcodet::NONZERO, width, operand_width, ops[0]);
+      else if (is_signed && width > operand_width)
+        result = add_instruction(opcodet::SEXT, width, operand_width, ops[0]);
+      else
+        result = add_instruction(opcodet::TRUNC, width, operand_width, ops[0]);
+    }
+    else
+      return false;
+  }
+  else if (ops.size() == 2)
+  {
+    if (id == ID_minus)
+      result = add_instruction(opcodet::SUB, width, width, ops[0], ops[1]);
+    else if (id == ID_shl)
+      result = add_instruction(opcodet::SHL, width, width, ops[0], ops[1]);
+    else if (id == ID_lshr)
+      result = add_instruction(opcodet::LSHR, width, width, ops[0], ops[1]);
+    else if (id == ID_ashr)
+      result = add_instruction(opcodet::ASHR, width, width, ops[0], ops[1]);
+    else if (id == ID_equal)
+      result = add_instruction(
+          opcodet::EQ, width, operand_width, ops[0], ops[1]);
+    else if (id == ID_notequal)
+      result = add_instruction(
+          opcodet::NE, width, operand_width, ops[0], ops[1]);
+    else if (id == ID_lt || id == ID_gt)
+    {
+      const bool swap = id == ID_gt;
+      result = add_instruction(
+          is_signed ? opcodet::SLT : opcodet::ULT,
+          width,
+          operand_width,
+          ops[swap ? 1 : 0],
+          ops[swap ? 0 : 1]);
+    }
+    else if (id == ID_le || id == ID_ge)
+    {
+      const bool swap = id == ID_ge;
+      result = add_instruction(
+          is_signed ? opcodet::SLE : opcodet::ULE,
+          width,
+          operand_width,
+          ops[swap ? 1 : 0],
+          ops[swap ? 0 : 1]);
+    }
+    else if (id == ID_implies)
+    {
+      const std::size_t negated =
+          add_instruction(opcodet::NOT, width, width, ops[0]);
+      result = add_instruction(opcodet::OR, width, width, negated, ops[1]);
+    }
+    else
+      return false;
+  }
+  else if (ops.size() == 3 && id == ID_if)
+  {
+    result = add_instruction(
+        opcodet::ITE, width, width, ops[0], ops[1], ops[2]);
+  }
+  else
+    return false;
+
+  compiled[expr] = result;
+  return true;
+}
+
+void batch_evaluatort::execute(
+    const instructiont &instruction,
+    std::uint64_t *r,
+    const std::vector<const std::uint64_t *> &inputs,
+    std::size_t offset,
+    std::size_t count)
+{
+  const std::uint64_t *a = registers.data() + instruction.op0 * block_size;
+  const std::uint64_t *b = registers.data() + instruction.op1 * block_size;
+  const std::uint64_t *c = registers.data() + instruction.op2 * block_size;
+  const std::size_t width = instruction.width;
+  const std::size_t operand_width = instruction.operand_width;
+  const std::uint64_t m = mask(width);
+  std::size_t i = 0;
+
+#ifdef FASTSYNTH_SIMD
+  static const vector_kernelt vector_kernel = select_vector_kernel();
+
+  // the loops below do the remaining lanes
+  if (vector_kernel != nullptr)
+    i = vector_kernel(instruction.opcode, width, operand_width, r, a, b, count);
+#endif
+
+  switch (instruction.opcode)
+  {
+  case opcodet::INPUT:
+  {
+    const std::uint64_t *input = inputs[instruction.constant] + offset;
+    for (; i < count; i++)
+      r[i] = input[i] & m;
+  }
+  break;
+
+  case opcodet::CONSTANT:
+    std::fill(r, r + count, instruction.constant);
+    break;
+
+  case opcodet::ADD:
+    for (; i < count; i++)
+      r[i] = (a[i] + b[i]) & m;
+    break;
+
+  case opcodet::SUB:
+    for (; i < count; i++)
+      r[i] = (a[i] - b[i]) & m;
+    break;
+
+  case opcodet::MUL:
+    for (; i < count; i++)
+      r[i] = (a[i] * b[i]) & m;
+    break;
+
+  case opcodet::AND:
+    for (; i < count; i++)
+      r[i] = a[i] & b[i];
+    break;
+
+  case opcodet::OR:
+    for (; i < count; i++)
+      r[i] = a[i] | b[i];
+    break;
+
+  case opcodet::XOR:
+    for (; i < count; i++)
+      r[i] = a[i] ^ b[i];
+    break;
+
+  case opcodet::NOT:
+    for (; i < count; i++)
+      r[i] = a[i] ^ m;
+    break;
+
+  case opcodet::NEG:
+    for (; i < count; i++)
+      r[i] = (0 - a[i]) & m;
+    break;
+
+  case opcodet::SHL:
+    for (; i < count; i++)
+      r[i] = b[i] >= width ? 0 : (a[i] << b[i]) & m;
+    break;
+
+  case opcodet::LSHR:
+    for (; i < count; i++)
+      r[i] = b[i] >= width ? 0 : a[i] >> b[i];
+    break;
+
+  case opcodet::ASHR:
+    for (; i < count; i++)
+    {
+      const std::uint64_t distance = std::min<std::uint64_t>(b[i], width - 1);
+      r[i] = static_cast<std::uint64_t>(
+                 static_cast<std::int64_t>(sign_extend(a[i], width)) >>
+                 distance) &
+             m;
+    }
+    break;
+
+  case opcodet::EQ:
+    for (; i < count; i++)
+      r[i] = a[i] == b[i];
+    break;
+
+  case opcodet::NE:
+    for (; i < count; i++)
+      r[i] = a[i] != b[i];
+    break;
+
+  case opcodet::ULT:
+    for (; i < count; i++)
+      r[i] = a[i] < b[i];
+    break;
+
+  case opcodet::ULE:
+    for (; i < count; i++)
+      r[i] = a[i] <= b[i];
+    break;
+
+  case opcodet::SLT:
+  case opcodet::SLE:
+  {
+    const bool strict = instruction.opcode == opcodet::SLT;
+    for (; i < count; i++)
+    {
+      const auto sa =
+          static_cast<std::int64_t>(sign_extend(a[i], operand_width));
+      const auto sb =
+          static_cast<std::int64_t>(sign_extend(b[i], operand_width));
+      r[i] = strict ? sa < sb : sa <= sb;
+    }
+  }
+  break;
+
+  case opcodet::ITE:
+    for (; i < count; i++)
+      r[i] = a[i] != 0 ? b[i] : c[i];
+    break;
+
+  case opcodet::NONZERO:
+    for (; i < count; i++)
+      r[i] = a[i] != 0;
+    break;
+
+  case opcodet::SEXT:
+    for (; i < count; i++)
+      r[i] = sign_extend(a[i], operand_width) & m;
+    break;
+
+  case opcodet::TRUNC:
+    for (; i < count; i++)
+      r[i] = a[i] & m;
+    break;
+  }
+}
+
+void batch_evaluatort::operator()(
+    const std::vector<const std::uint64_t *> &inputs,
+    std::size_t count,
+    std::uint64_t *result)
+{
+  registers.resize(program.size() * block_size);
+
+  for (std::size_t offset = 0; offset < count; offset += block_size)
+  {
+    const std::size_t block = std::min(block_size, count - offset);
+
+    for (std::size_t i = 0; i < program.size(); i++)
+      execute(
+          program[i],
+          registers.data() + i * block_size,
+          inputs,
+          offset,
+          block);
+
+    const std::uint64_t *r = registers.data() + result_register * block_size;
+    std::copy(r, r + block, result + offset);
+  }
+}
@@ -0,0 +1,125 @@
+#ifndef CPROVER_FASTSYNTH_BATCH_EVALUATOR_H_
+#define CPROVER_FASTSYNTH_BATCH_EVALUATOR_H_
+
+#include <util/expr.h>
+#include <util/irep_hash.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/// Evaluates an expression on many inputs at once. The expression is
+/// compiled into a straight-line program over arrays of 64-bit lanes, one
+/// lane per input, each holding the zero-extended bit pattern of a value.
+/// Booleans and bit-vectors of up to 64 bits are supported. Narrower
+/// words are not packed: an 8-bit word takes a whole lane, so that the
+/// inputs, registers and results of all widths share one layout.
+/// The kernels use AVX-512 or AVX2 when the processor supports them.
+class batch_evaluatort
+{
+public:
+  batch_evaluatort() : result_register(0)
+  {
+  }
+
+  /// Compiles an expression.
+  /// \param expr Expression to evaluate.
+  /// \param variables Symbols the inputs are given for, in order.
+  /// \return False if the expression has an unsupported operator or type.
+  bool compile(const exprt &expr, const std::vector<exprt> &variables);
+
+  /// Evaluates the compiled expression.
+  /// \param inputs One array of \p count lanes per variable.
+  /// \param count Number of inputs.
+  /// \param result Receives \p count lanes.
+  void operator()(
+      const std::vector<const std::uint64_t *> &inputs,
+      std::size_t count,
+      std::uint64_t *result);
+
+  static bool is_supported(const typet &);
+
+  /// Bit pattern of a constant of a supported type.
+  static std::uint64_t to_lane(const exprt &);
+
+  /// Constant of the given type with the given bit pattern.
+  static exprt from_lane(std::uint64_t, const typet &);
+
+  /// Number of inputs evaluated in one pass over the program.
+  static const std::size_t block_size = 512;
+
+  /// Instructions of the compiled programs.
+  enum class opcodet
+  {
+    INPUT,
+    CONSTANT,
+    ADD,
+    SUB,
+    MUL,
+    AND,
+    OR,
+    XOR,
+    NOT,
+    NEG,
+    SHL,
+    LSHR,
+    ASHR,
+    EQ,
+    NE,
+    ULT,
+    ULE,
+    SLT,
+    SLE,
+    ITE,
+    NONZERO,
+    SEXT,
+    TRUNC
+  };
+
+protected:
+  struct instructiont
+  {
+    opcodet opcode;
+
+    /// Width of the result.
+    std::size_t width;
+
+    /// Width of the operands of comparisons and sign extension.
+    std::size_t operand_width;
+
+    std::size_t op0, op1, op2;
+
+    /// Value of CONSTANT, or input number of INPUT.
+    std::uint64_t constant;
+  };
+
+  std::vector<instructiont> program;
+  std::size_t result_register;
+
+  /// Register file, block_size lanes per instruction.
+  std::vector<std::uint64_t> registers;
+
+  using compiledt = std::unordered_map<exprt, std::size_t, irep_hash>;
+
+  /// Compiles a subexpression.
+  /// \return False if unsupported.
+  bool compile_rec(const exprt &, compiledt &, std::size_t &);
+
+  std::size_t add_instruction(
+      opcodet,
+      std::size_t width,
+      std::size_t operand_width,
+      std::size_t op0 = 0,
+      std::size_t op1 = 0,
+      std::size_t op2 = 0,
+      std::uint64_t constant = 0);
+
+  void execute(
+      const instructiont &,
+      std::uint64_t *result,
+      const std::vector<const std::uint64_t *> &inputs,
+      std::size_t offset,
+      std::size_t count);
+};
+
+#endif /* CPROVER_FASTSYNTH_BATCH_EVALUATOR_H_ */
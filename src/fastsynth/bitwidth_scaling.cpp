@@ -0,0 +1,257 @@
+#include "bitwidth_scaling.h"
+
+#include <util/arith_tools.h>
+#include <util/mathematical_types.h>
+#include <util/std_types.h>
+
+/// Truncates a value to the given width.
+/// \param value Value to truncate.
+/// \param width Width in bits.
+/// \param is_signed Whether the result is interpreted as two's complement.
+/// \return Value of the lower \p width bits of \p value.
+static mp_integer
+truncate(const mp_integer &value, std::size_t width, bool is_signed)
+{
+  const mp_integer modulus = power(2, width);
+  mp_integer result = value % modulus;
+
+  if (result.is_negative())
+    result += modulus;
+
+  if (is_signed && result >= modulus / 2)
+    result -= modulus;
+
+  return result;
+}
+
+static bool is_scalable(const typet &type)
+{
+  return type.id() == ID_signedbv || type.id() == ID_unsignedbv;
+}
+
+bool bitwidth_scalingt::collect_widths(
+    const typet &type,
+    std::set<std::size_t> &widths) const
+{
+  if (is_scalable(type))
+  {
+    widths.insert(to_bitvector_type(type).get_width());
+    return true;
+  }
+  else if (type.id() == ID_mathematical_function)
+  {
+    const auto &function_type = to_mathematical_function_type(type);
+    for (const auto &d : function_type.domain())
+      if (!collect_widths(d, widths))
+        return false;
+    return collect_widths(function_type.codomain(), widths);
+  }
+  else if (type.id() == ID_bool || type.id() == ID_empty ||
+           type.id() == ID_tuple || type.id().empty() || type.is_nil())
+  {
+    return true;
+  }
+
+  // arrays, pointers, floats and the like are left alone
+  return false;
+}
+
+bool bitwidth_scalingt::collect_widths(
+    const exprt &expr,
+    std::set<std::size_t> &widths) const
+{
+  for (const auto &op : expr.operands())
+    if (!collect_widths(op, widths))
+      return false;
+
+  return collect_widths(expr.type(), widths);
+}
+
+void bitwidth_scalingt::convert(
+    typet &type,
+    std::size_t from,
+    std::size_t to) const
+{
+  if (is_scalable(type))
+  {
+    if (to_bitvector_type(type).get_width() == from)
+      to_bitvector_type(type).set_width(to);
+  }
+  else if (type.id() == ID_mathematical_function)
+  {
+    auto &function_type = to_mathematical_function_type(type);
+    for (auto &d : function_type.domain())
+      convert(d, from, to);
+    convert(function_type.codomain(), from, to);
+  }
+}
+
+bool bitwidth_scalingt::scale(problemt &problem)
+{
+  std::set<std::size_t> widths;
+
+  for (const auto &e : problem.free_variables)
+    if (!collect_widths(e, widths))
+      return false;
+
+  for (const auto &e : problem.side_conditions)
+    if (!collect_widths(e, widths))
+      return false;
+
+  for (const auto &e : problem.constraints)
+    if (!collect_widths(e, widths))
+      return false;
+
+  if (widths.size() != 1 || *widths.begin() <= width)
+    return false;
+
+  full_width = *widths.begin();
+  constant_values.clear();
+  ambiguous_values.clear();
+
+  std::set<exprt> free_variables;
+  for (exprt e : problem.free_variables)
+  {
+    scale(e);
+    free_variables.insert(e);
+  }
+  problem.free_variables.swap(free_variables);
+
+  for (auto &e : problem.side_conditions)
+    scale(e);
+
+  for (auto &e : problem.constraints)
+    scale(e);
+
+  std::set<constant_exprt> literals;
+  for (const auto &l : problem.literals)
+  {
+    exprt tmp = l;
+    scale(tmp);
+    literals.insert(to_constant_expr(tmp));
+  }
+  problem.literals.swap(literals);
+
+  // scaling may merge literals
+  std::vector<constant_exprt> lazy_literals;
+  std::set<constant_exprt> seen(problem.literals);
+  for (const auto &l : problem.lazy_literals)
+  {
+    exprt tmp = l;
+    scale(tmp);
+    if (seen.insert(to_constant_expr(tmp)).second)
+      lazy_literals.push_back(to_constant_expr(tmp));
+  }
+  problem.lazy_literals.swap(lazy_literals);
+
+  return true;
+}
+
+void bitwidth_scalingt::scale(exprt &expr)
+{
+  for (auto &op : expr.operands())
+    scale(op);
+
+  if (expr.id() == ID_constant && is_scalable(expr.type()))
+  {
+    mp_integer value;
+    if (to_integer(to_constant_expr(expr), value))
+      return;
+
+    const bool is_signed = expr.type().id() == ID_signedbv;
+    const mp_integer scaled = truncate(value, width, is_signed);
+
+    // remember where the value came from, to undo this when lifting
+    const auto entry = constant_values.emplace(scaled, value);
+    if (!entry.second && entry.first->second != value)
+      ambiguous_values.insert(scaled);
+
+    typet type = expr.type();
+    convert(type, full_width, width);
+    expr = from_integer(scaled, type);
+  }
+  else
+    convert(expr.type(), full_width, width);
+}
+
+solutiont bitwidth_scalingt::lift(const solutiont &solution) const
+{
+  solutiont result;
+
+  for (const auto &f : solution.functions)
+  {
+    symbol_exprt symbol = f.first;
+    convert(symbol.type(), width, full_width);
+    exprt body = f.second;
+    lift(body);
+    result.functions[symbol] = body;
+  }
+
+  for (const auto &f : solution.s_functions)
+  {
+    symbol_exprt symbol = f.first;
+    convert(symbol.type(), width, full_width);
+    exprt body = f.second;
+    lift(body);
+    result.s_functions[symbol] = body;
+  }
+
+  return result;
+}
+
+void bitwidth_scalingt::lift(exprt &expr) const
+{
+  const bool is_shift =
+      expr.id() == ID_shl || expr.id() == ID_lshr || expr.id() == ID_ashr;
+
+  for (auto &op : expr.operands())
+  {
+    // shift distances scale with the width
+    if (is_shift && &op == &expr.operands().back() &&
+        op.id() == ID_constant && is_scalable(op.type()))
+    {
+      mp_integer distance;
+      if (!to_integer(to_constant_expr(op), distance) &&
+          (distance == width || distance == width - 1))
+      {
+        typet type = op.type();
+        convert(type, width, full_width);
+        op = from_integer(distance + full_width - width, type);
+        continue;
+      }
+    }
+
+    lift(op);
+  }
+
+  if (expr.id() == ID_constant && is_scalable(expr.type()))
+  {
+    mp_integer value;
+    if (to_integer(to_constant_expr(expr), value))
+      return;
+
+    const bool is_signed = expr.type().id() == ID_signedbv;
+    const mp_integer top = power(2, width - 1);
+    mp_integer lifted = value;
+
+    const auto c_it = constant_values.find(value);
+
+    if (c_it != constant_values.end() &&
+        ambiguous_values.find(value) == ambiguous_values.end())
+    {
+      lifted = c_it->second;
+    }
+    else if (!is_signed && value == top * 2 - 1)
+      lifted = power(2, full_width) - 1; // all ones
+    else if (is_signed && value == -top)
+      lifted = -power(2, full_width - 1); // smallest value
+    else if (is_signed && value == top - 1)
+      lifted = power(2, full_width - 1) - 1; // largest value
+
+    typet type = expr.type();
+    convert(type, width, full_width);
+    expr = from_integer(lifted, type);
+  }
+  else
+    convert(expr.type(), width, full_width);
+}
@@ -0,0 +1,49 @@
+#ifndef CPROVER_FASTSYNTH_BITWIDTH_SCALING_H_
+#define CPROVER_FASTSYNTH_BITWIDTH_SCALING_H_
+
+#include <util/mp_arith.h>
+
+#include "cegis_types.h"
+
+/// Reduces the word width of a bit-vector synthesis problem, and lifts
+/// candidates found for the reduced problem back to the full width.
+class bitwidth_scalingt
+{
+public:
+  explicit bitwidth_scalingt(std::size_t _width) : width(_width),
+                                                   full_width(0)
+  {
+  }
+
+  /// Replaces all bit-vector types of the problem by types of the
+  /// reduced width. Constants are truncated.
+  /// \param problem Problem to scale.
+  /// \return True if the problem was scaled; false if it has no
+  ///   bit-vectors wider than the reduced width, or mixes several widths.
+  bool scale(problemt &problem);
+
+  /// Lifts a solution of the scaled problem to the full width.
+  /// Constants taken from the problem get their original value back;
+  /// masks and shift distances are widened.
+  solutiont lift(const solutiont &) const;
+
+  /// Reduced width.
+  const std::size_t width;
+
+  /// Width of the original problem, known after scale().
+  std::size_t full_width;
+
+protected:
+  /// Original values of the constants of the problem, by scaled value.
+  std::map<mp_integer, mp_integer> constant_values;
+  std::set<mp_integer> ambiguous_values;
+
+  bool collect_widths(const exprt &, std::set<std::size_t> &) const;
+  bool collect_widths(const typet &, std::set<std::size_t> &) const;
+
+  void scale(exprt &);
+  void lift(exprt &) const;
+  void convert(typet &, std::size_t from, std::size_t to) const;
+};
+
+#endif /* CPROVER_FASTSYNTH_BITWIDTH_SCALING_H_ */
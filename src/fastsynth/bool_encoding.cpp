@@ -0,0 +1,97 @@
+#include "bool_encoding.h"
+
+#include <utility>
+
+literalt bool_encodingt::land(literalt a, literalt b)
+{
+  if (a.is_constant() || b.is_constant() || a == b || a == !b)
+    return prop.land(a, b);
+
+  if (b.get() < a.get())
+    std::swap(a, b);
+
+  const gate_keyt key(gate_kindt::AND, a.get(), b.get(), 0);
+  const auto it = gates.find(key);
+
+  if (it != gates.end())
+  {
+    hits++;
+    return it->second;
+  }
+
+  const literalt result = prop.land(a, b);
+  gates.emplace(key, result);
+  return result;
+}
+
+literalt bool_encodingt::lor(literalt a, literalt b)
+{
+  // share the gates with land
+  return !land(!a, !b);
+}
+
+literalt bool_encodingt::lxor(literalt a, literalt b)
+{
+  if (a.is_constant() || b.is_constant() || a.var_no() == b.var_no())
+    return prop.lxor(a, b);
+
+  // the gate is kept for positive inputs; negations flip the output
+  const bool sign = a.sign() != b.sign();
+  a.set(a.var_no(), false);
+  b.set(b.var_no(), false);
+
+  if (b.get() < a.get())
+    std::swap(a, b);
+
+  const gate_keyt key(gate_kindt::XOR, a.get(), b.get(), 0);
+  const auto it = gates.find(key);
+  literalt result;
+
+  if (it != gates.end())
+  {
+    hits++;
+    result = it->second;
+  }
+  else
+  {
+    result = prop.lxor(a, b);
+    gates.emplace(key, result);
+  }
+
+  return sign ? !result : result;
+}
+
+literalt bool_encodingt::lselect(literalt s, literalt a, literalt b)
+{
+  if (a == b)
+    return a;
+
+  if (s.is_constant() || a.is_constant() || b.is_constant())
+    return prop.lselect(s, a, b);
+
+  // a negated selector swaps the branches
+  if (s.sign())
+  {
+    s = !s;
+    std::swap(a, b);
+  }
+
+  const gate_keyt key(gate_kindt::SELECT, s.get(), a.get(), b.get());
+  const auto it = gates.find(key);
+
+  if (it != gates.end())
+  {
+    hits++;
+    return it->second;
+  }
+
+  const literalt result = prop.lselect(s, a, b);
+  gates.emplace(key, result);
+  return result;
+}
+
+void bool_encodingt::set_equal(literalt a, literalt b)
+{
+  prop.lcnf(!a, b);
+  prop.lcnf(a, !b);
+}
@@ -0,0 +1,62 @@
+#ifndef CPROVER_FASTSYNTH_BOOL_ENCODING_H_
+#define CPROVER_FASTSYNTH_BOOL_ENCODING_H_
+
+#include <solvers/prop/prop.h>
+#include <solvers/prop/prop_conv.h>
+
+#include <map>
+#include <tuple>
+
+/// Emits Boolean gates directly as clauses, for the instructions of
+/// functions with a Boolean word type. Gates are hashed structurally,
+/// so a gate over the same inputs is encoded only once; this shares
+/// the options that the instructions of an instance have in common.
+class bool_encodingt
+{
+public:
+  /// \param converter Flattening that owns the symbols.
+  /// \param prop Propositional back end the flattening writes to.
+  bool_encodingt(prop_convt &_converter, propt &_prop):
+    hits(0), converter(_converter), prop(_prop)
+  {
+  }
+
+  /// Literal for a Boolean expression, such as a selector, a result
+  /// symbol or an argument.
+  literalt convert(const exprt &expr)
+  {
+    return converter.convert(expr);
+  }
+
+  literalt land(literalt, literalt);
+  literalt lor(literalt, literalt);
+  literalt lxor(literalt, literalt);
+
+  /// \return a if s holds, b otherwise.
+  literalt lselect(literalt s, literalt a, literalt b);
+
+  /// Constrains two literals to be equal.
+  void set_equal(literalt, literalt);
+
+  /// Number of gates found in the hash table.
+  std::size_t hits;
+
+  /// Number of gates in the hash table.
+  std::size_t size() const
+  {
+    return gates.size();
+  }
+
+protected:
+  prop_convt &converter;
+  propt &prop;
+
+  enum class gate_kindt { AND, XOR, SELECT };
+
+  using gate_keyt = std::tuple<
+    gate_kindt, literalt::var_not, literalt::var_not, literalt::var_not>;
+
+  std::map<gate_keyt, literalt> gates;
+};
+
+#endif /* CPROVER_FASTSYNTH_BOOL_ENCODING_H_ */
@@ -222,8 +222,14 @@ int c_frontend(const cmdlinet &cmdline)
 #endif
 
   problemt problem = to_problem(mh, options, goto_model);
-  if (cmdline.isset("literals"))
-    add_literals(problem);
+  if (cmdline.isset("literals") || cmdline.isset("lazy-literals"))
+  {
+    const std::size_t max_literals =
+        cmdline.isset("max-literals")
+            ? std::stoul(cmdline.get_value("max-literals"))
+            : 8;
+    add_literals(problem, max_literals, cmdline.isset("lazy-literals"));
+  }
 
   cegist cegis(ns);
   cegis.set_message_handler(mh);
@@ -239,6 +245,37 @@ int c_frontend(const cmdlinet &cmdline)
   cegis.enable_division = cmdline.isset("enable-division");
   cegis.logic = "BV"; //default logic
 
+  if (cmdline.isset("width-scaling"))
+    cegis.scaled_width = std::stoul(cmdline.get_value("width-scaling"));
+
+  if (cmdline.isset("learner"))
+    cegis.learner_name = cmdline.get_value("learner");
+
+  cegis.exhaustive_verify = cmdline.isset("exhaustive-verify");
+  cegis.parallel_verify = cmdline.isset("parallel-verify");
+
+  if (cmdline.isset("verify-jobs"))
+    cegis.verify_jobs = std::stoul(cmdline.get_value("verify-jobs"));
+
+  if (cmdline.isset("sat-solver"))
+    cegis.learner_sat_solver = cegis.verifier_sat_solver =
+        cmdline.get_value("sat-solver");
+
+  if (cmdline.isset("learner-sat-solver"))
+    cegis.learner_sat_solver = cmdline.get_value("learner-sat-solver");
+
+  if (cmdline.isset("verifier-sat-solver"))
+    cegis.verifier_sat_solver = cmdline.get_value("verifier-sat-solver");
+
+  if (cmdline.isset("sat-portfolio"))
+    cegis.sat_portfolio = std::stoul(cmdline.get_value("sat-portfolio"));
+
+  cegis.use_fm = cmdline.isset("fm");
+  cegis.theory_constants = cmdline.isset("cegis-t") || cegis.use_fm;
+
+  if (cmdline.isset("operator-budget"))
+    cegis.operator_budget = std::stoul(cmdline.get_value("operator-budget"));
+
   auto start_time = std::chrono::steady_clock::now();
 
   switch (cegis(problem))
@@ -0,0 +1,75 @@
+#include "cached_smt2_dec.h"
+#include "query_cache.h"
+#include "query_capture.h"
+
+#include <util/run.h>
+#include <util/tempfile.h>
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+decision_proceduret::resultt cached_smt2_dect::dec_solve()
+{
+  std::ostringstream problem;
+  problem << stringstream.str();
+  write_footer(problem);
+
+  query_hasht hash;
+  hash.add("z3\n");
+  hash.add(problem.str());
+
+  std::string response;
+
+  if (!query_cache().lookup(hash, response))
+  {
+    temporary_filet
+      temp_file_problem("smt2_dec_problem_", ""),
+      temp_file_stdout("smt2_dec_stdout_", "");
+
+    {
+      std::ofstream problem_out(temp_file_problem());
+      problem_out << problem.str();
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
+
+    const int res = run(
+      "z3",
+      {"z3", "-smt2", temp_file_problem()},
+      "",
+      temp_file_stdout(),
+      "");
+
+    const std::chrono::duration<double> seconds =
+      std::chrono::steady_clock::now() - start_time;
+
+    if (res < 0)
+    {
+      error() << "error running SMT2 solver" << eom;
+      return resultt::D_ERROR;
+    }
+
+    std::ifstream out(temp_file_stdout());
+    std::ostringstream contents;
+    contents << out.rdbuf();
+    response = contents.str();
+
+    std::string result = "error";
+
+    if (res == 0 && response.compare(0, 4, "sat\n") == 0)
+      result = "sat";
+    else if (res == 0 && response.compare(0, 6, "unsat\n") == 0)
+      result = "unsat";
+
+    // as in smt2_sessiont, "unknown" and errors are not cached
+    if (result != "error")
+      query_cache().store(hash, response);
+
+    query_capture().capture(
+      query_capture().role, "smt2", problem.str(), result, seconds.count());
+  }
+
+  std::istringstream in(response);
+  return read_result(in);
+}
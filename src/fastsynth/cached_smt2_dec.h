@@ -0,0 +1,29 @@
+#ifndef CPROVER_FASTSYNTH_CACHED_SMT2_DEC_H_
+#define CPROVER_FASTSYNTH_CACHED_SMT2_DEC_H_
+
+#include <solvers/smt2/smt2_dec.h>
+
+/// Runs Z3 on the query like smt2_dect, but looks the query up in
+/// query_cache() first and stores the response there. The queries that
+/// Z3 is run on are passed to query_capture().
+class cached_smt2_dect:public smt2_dect
+{
+public:
+  cached_smt2_dect(
+    const namespacet &_ns,
+    const std::string &_logic,
+    message_handlert &_message_handler):
+    smt2_dect(
+      _ns,
+      "fastsynth",
+      "created by fastsynth",
+      _logic,
+      smt2_dect::solvert::Z3)
+  {
+    set_message_handler(_message_handler);
+  }
+
+  resultt dec_solve() override;
+};
+
+#endif /* CPROVER_FASTSYNTH_CACHED_SMT2_DEC_H_ */
@@ -1,17 +1,106 @@
 #include "cegis.h"
+#include "bitwidth_scaling.h"
+#include "component_learn.h"
+#include "decision_tree_learn.h"
+#include "enumerative_learn.h"
+#include "exhaustive_verify.h"
 #include "incremental_solver_learn.h"
+#include "parallel_verify.h"
+#include "query_cache.h"
+#include "query_capture.h"
 #include "solver_learn.h"
+#include "theory_constants.h"
 #include "verify.h"
 
 #include <langapi/language_util.h>
 
 #include <util/simplify_expr.h>
 
+#include <algorithm>
 #include <memory>
 
 decision_proceduret::resultt cegist::operator()(
     const problemt &problem)
 {
+  std::vector<counterexamplet> counterexamples;
+
+  if (scaled_width != 0)
+  {
+    counterexamplet counterexample;
+
+    switch (solve_scaled(problem, counterexample))
+    {
+    case decision_proceduret::resultt::D_SATISFIABLE:
+      result() << bold << "VERIFICATION SUCCESSFUL" << reset << eom;
+      return decision_proceduret::resultt::D_SATISFIABLE;
+
+    case decision_proceduret::resultt::D_UNSATISFIABLE:
+    case decision_proceduret::resultt::D_ERROR:
+      break;
+    }
+
+    status() << "** Falling back to full width" << eom;
+
+    // the lifted candidate failed on this one
+    if (!counterexample.assignment.empty())
+      counterexamples.push_back(counterexample);
+  }
+
+  const auto solve_result = solve(problem, counterexamples);
+
+  if (solve_result == decision_proceduret::resultt::D_SATISFIABLE)
+    result() << bold << "VERIFICATION SUCCESSFUL" << reset << eom;
+
+  return solve_result;
+}
+
+decision_proceduret::resultt cegist::solve_scaled(
+    const problemt &problem,
+    counterexamplet &counterexample)
+{
+  bitwidth_scalingt scaling(scaled_width);
+  problemt scaled_problem = problem;
+
+  if (!scaling.scale(scaled_problem))
+  {
+    status() << "** Bit-width scaling not applicable" << eom;
+    return decision_proceduret::resultt::D_ERROR;
+  }
+
+  status() << "** Bit-width scaling from " << scaling.full_width
+           << " to " << scaled_width << " bits" << eom;
+
+  if (solve(scaled_problem, {}) != decision_proceduret::resultt::D_SATISFIABLE)
+    return decision_proceduret::resultt::D_ERROR;
+
+  solution = scaling.lift(solution);
+
+  status() << "** Verification phase at full width" << eom;
+
+  const auto verifier = new_verifier(problem);
+  const auto verify_result = (*verifier)(solution);
+
+  if (verify_result == decision_proceduret::resultt::D_SATISFIABLE)
+  {
+    status() << "** Lifted candidate failed at full width" << eom;
+    counterexample = verifier->get_counterexample();
+    solution.functions.clear();
+    solution.s_functions.clear();
+    return decision_proceduret::resultt::D_UNSATISFIABLE;
+  }
+
+  return verify_result == decision_proceduret::resultt::D_UNSATISFIABLE
+             ? decision_proceduret::resultt::D_SATISFIABLE
+             : decision_proceduret::resultt::D_ERROR;
+}
+
+decision_proceduret::resultt cegist::solve(
+    const problemt &original_problem,
+    const std::vector<counterexamplet> &counterexamples)
+{
+  // lazy literals are moved into the literals of a copy
+  problemt problem = original_problem;
+
   std::unique_ptr<learnt> learner;
   std::unique_ptr<verifyt> verifier;
 
@@ -30,6 +119,13 @@ decision_proceduret::resultt cegist::operator()(
     incremental_solving = false;
   }
 
+  if (learner_name != "solver" && learner_name != "component" &&
+      learner_name != "enumerative" && learner_name != "decision-tree")
+  {
+    error() << "unknown learner `" << learner_name << "'" << eom;
+    return decision_proceduret::resultt::D_ERROR;
+  }
+
   /* if(incremental_solving)
   {
     status() << "** incremental CEGIS" << eom;
@@ -37,30 +133,78 @@ decision_proceduret::resultt cegist::operator()(
       ns, problem, use_simp_solver, get_message_handler()));
   }
   else*/
+  if (learner_name == "enumerative")
+  {
+    status() << "** enumerative CEGIS" << eom;
+    learner = std::unique_ptr<learnt>(
+        new enumerative_learnt(ns, problem, get_message_handler()));
+  }
+  else if (learner_name == "decision-tree")
+  {
+    status() << "** decision-tree CEGIS" << eom;
+    learner = std::unique_ptr<learnt>(
+        new decision_tree_learnt(ns, problem, get_message_handler()));
+  }
+  else
   {
     status() << "** non-incremental CEGIS" << eom;
-    solver_learnt *l = new solver_learnt(
-        ns, problem, get_message_handler());
+    solver_learnt *l;
+
+    if (learner_name == "component")
+    {
+      status() << "** component-based encoding" << eom;
+      l = new component_learnt(ns, problem, get_message_handler());
+    }
+    else
+      l = new solver_learnt(ns, problem, get_message_handler());
 
     l->use_smt = use_smt;
     l->logic = logic;
+    l->sat_solver = learner_sat_solver;
+    l->sat_portfolio = sat_portfolio;
 
     learner = std::unique_ptr<learnt>(l);
   }
 
   learner->enable_bitwise = enable_bitwise;
+  learner->operator_budget = operator_budget;
+  learner->distinct_integer_constants = theory_constants;
+
+  verifier = new_verifier(problem);
+
+  for (const auto &c : counterexamples)
+    learner->add_ce(c);
+
+  return loop(problem, *learner, *verifier);
+}
 
-  verifier =
-      std::unique_ptr<verifyt>(new verifyt(ns, problem, get_message_handler()));
+std::unique_ptr<verifyt> cegist::new_verifier(const problemt &problem)
+{
+  std::unique_ptr<verifyt> verifier;
+
+  if (exhaustive_verify)
+    verifier = std::unique_ptr<verifyt>(
+        new exhaustive_verifyt(ns, problem, get_message_handler()));
+  else if (parallel_verify)
+  {
+    auto parallel_verifier = std::unique_ptr<parallel_verifyt>(
+        new parallel_verifyt(ns, problem, get_message_handler()));
+    parallel_verifier->max_jobs = verify_jobs;
+    verifier = std::move(parallel_verifier);
+  }
+  else
+    verifier = std::unique_ptr<verifyt>(
+        new verifyt(ns, problem, get_message_handler()));
 
   verifier->use_smt = use_smt;
   verifier->logic = logic;
+  verifier->sat_solver = verifier_sat_solver;
 
-  return loop(problem, *learner, *verifier);
+  return verifier;
 }
 
 decision_proceduret::resultt cegist::loop(
-    const problemt &problem,
+    problemt &problem,
     learnt &learn,
     verifyt &verify)
 {
@@ -69,6 +213,12 @@ decision_proceduret::resultt cegist::loop(
   std::size_t program_size = 1;
   learn.set_array_size(array_size);
 
+  theory_constantst constants(ns, problem, get_message_handler());
+  constants.use_fm = use_fm;
+  constants.use_smt = use_smt;
+  constants.logic = logic;
+  constants.sat_solver = verifier_sat_solver;
+
   // now enter the CEGIS loop
   while (true)
   {
@@ -79,6 +229,10 @@ decision_proceduret::resultt cegist::loop(
 
     learn.set_program_size(program_size);
 
+    query_capture().iteration = iteration;
+    query_capture().program_size = program_size;
+    query_capture().role = "learner";
+
     switch (learn())
     {
     case decision_proceduret::resultt::D_SATISFIABLE: // got candidate
@@ -104,6 +258,14 @@ decision_proceduret::resultt cegist::loop(
     break;
 
     case decision_proceduret::resultt::D_UNSATISFIABLE: // no candidate
+      if (add_lazy_literals(problem))
+      {
+        status() << "Failed to get candidate; "
+                    "increasing number of literals to "
+                 << problem.literals.size() << eom;
+        continue; // do another attempt to synthesize
+      }
+
       if (program_size < max_program_size)
       {
         program_size += 1;
@@ -122,7 +284,17 @@ decision_proceduret::resultt cegist::loop(
 
     status() << "** Verification phase" << eom;
 
-    switch (verify(solution))
+    query_capture().role = "verifier";
+    decision_proceduret::resultt verify_result = verify(solution);
+
+    if (theory_constants &&
+        verify_result == decision_proceduret::resultt::D_SATISFIABLE &&
+        constants.set_template(solution))
+    {
+      verify_result = solve_constants(learn, verify, constants);
+    }
+
+    switch (verify_result)
     {
     case decision_proceduret::resultt::D_SATISFIABLE: // counterexample
       status() << "** Verification failed" << eom;
@@ -132,11 +304,69 @@ decision_proceduret::resultt cegist::loop(
     case decision_proceduret::resultt::D_UNSATISFIABLE: // done, got solution
       status() << "Result obtained with " << iteration << " iteration(s)"
                << eom;
-      result() << bold << "VERIFICATION SUCCESSFUL" << reset << eom;
+
+      if (query_cache().enabled())
+        statistics() << "Query cache: " << query_cache().hits << " hits, "
+                     << query_cache().misses << " misses" << eom;
+
+      return decision_proceduret::resultt::D_SATISFIABLE;
+
+    case decision_proceduret::resultt::D_ERROR:
+      return decision_proceduret::resultt::D_ERROR;
+    }
+  }
+}
+
+bool cegist::add_lazy_literals(problemt &problem) const
+{
+  if (problem.lazy_literals.empty())
+    return false;
+
+  const std::size_t count =
+      std::min(literal_batch, problem.lazy_literals.size());
+
+  problem.literals.insert(
+      problem.lazy_literals.begin(), problem.lazy_literals.begin() + count);
+  problem.lazy_literals.erase(
+      problem.lazy_literals.begin(), problem.lazy_literals.begin() + count);
+
+  return true;
+}
+
+decision_proceduret::resultt cegist::solve_constants(
+    learnt &learn,
+    verifyt &verify,
+    theory_constantst &constants)
+{
+  while (true)
+  {
+    constants.add_ce(verify.get_counterexample());
+
+    status() << "** Constant phase" << eom;
+
+    query_capture().role = "constants";
+    switch (constants(solution))
+    {
+    case decision_proceduret::resultt::D_SATISFIABLE:
+      break;
+
+    case decision_proceduret::resultt::D_UNSATISFIABLE:
+      // the structure is wrong, the learner gets the counterexample
+      status() << "** No constants for the candidate structure" << eom;
       return decision_proceduret::resultt::D_SATISFIABLE;
 
     case decision_proceduret::resultt::D_ERROR:
       return decision_proceduret::resultt::D_ERROR;
     }
+
+    learn.add_ce(verify.get_counterexample());
+
+    status() << "** Verification phase" << eom;
+
+    query_capture().role = "verifier";
+    const decision_proceduret::resultt result = verify(solution);
+
+    if (result != decision_proceduret::resultt::D_SATISFIABLE)
+      return result;
   }
 }
@@ -7,11 +7,14 @@
 
 #include "cegis_types.h"
 
+#include <memory>
+
 class synth_encodingt;
 class verify_encodingt;
 class prop_convt;
 class learnt;
 class verifyt;
+class theory_constantst;
 
 class cegist : public messaget
 {
@@ -25,6 +28,15 @@ public:
                                            use_smt(false),
                                            logic("BV"),
                                            array_size(10),
+                                           scaled_width(0),
+                                           learner_name("solver"),
+                                           exhaustive_verify(false),
+                                           sat_portfolio(1),
+                                           parallel_verify(false),
+                                           verify_jobs(0),
+                                           theory_constants(false),
+                                           literal_batch(4),
+                                           operator_budget(1),
                                            ns(_ns)
   {
   }
@@ -43,13 +55,86 @@ public:
   std::string logic; // used by smt
   std::size_t array_size;
 
+  /// Word width to learn bit-vector problems at first; 0 to disable
+  /// bit-width scaling.
+  std::size_t scaled_width;
+
+  /// Learner to use: "solver" for the default encoding, "component"
+  /// for the component-based encoding, "enumerative" or "decision-tree".
+  std::string learner_name;
+
+  /// Verify candidates by enumerating narrow input spaces.
+  bool exhaustive_verify;
+
+  /// SAT back ends of the learner and of the verifier, see
+  /// new_sat_solver().
+  std::string learner_sat_solver;
+  std::string verifier_sat_solver;
+
+  /// Number of copies of each learner query to run in parallel, see
+  /// portfolio_satt.
+  std::size_t sat_portfolio;
+
+  /// Verify clusters of constraints that share no free variables by
+  /// separate queries, in parallel.
+  bool parallel_verify;
+
+  /// Number of processes of the parallel verifier; 0 for one per
+  /// hardware thread.
+  std::size_t verify_jobs;
+
+  /// CEGIS(T): the learner fixes the structure of a candidate, and its
+  /// constants are found by a theory query over the counterexamples.
+  /// With use_fm, counterexamples are generalised by Fourier-Motzkin.
+  bool theory_constants;
+
+  /// Number of lazy literals added each time the learner fails.
+  std::size_t literal_batch;
+
+  /// Operators with a higher operator_cost() are not used by the
+  /// learners; raising it enables subtraction, bitwise and unary
+  /// operators, predicates and if-then-else.
+  std::size_t operator_budget;
+
   const namespacet &ns; // needed for array cegis loop
 
 protected:
-  decision_proceduret::resultt loop(
+  /// Runs CEGIS on the given problem, at the width of the problem.
+  /// \param problem Problem to solve.
+  /// \param counterexamples Counterexamples known up front.
+  decision_proceduret::resultt solve(
       const problemt &,
+      const std::vector<counterexamplet> &counterexamples);
+
+  /// Learns at scaled_width, then checks the lifted candidate at
+  /// full width.
+  /// \param problem Problem to solve.
+  /// \param counterexample Receives a full-width counterexample
+  ///   if the lifted candidate fails.
+  decision_proceduret::resultt solve_scaled(
+      const problemt &,
+      counterexamplet &counterexample);
+
+  /// The verifier selected by the options, for the given problem.
+  std::unique_ptr<verifyt> new_verifier(const problemt &);
+
+  decision_proceduret::resultt loop(
+      problemt &,
       learnt &,
       verifyt &);
+
+  /// Moves the next literal_batch lazy literals into the literals.
+  /// \return False if there are no lazy literals left.
+  bool add_lazy_literals(problemt &) const;
+
+  /// Searches for constants for the structure of the current candidate
+  /// until one passes verification or there are none.
+  /// \return The verification result of the last candidate; if
+  ///   D_SATISFIABLE, the counterexample is left in the verifier.
+  decision_proceduret::resultt solve_constants(
+      learnt &,
+      verifyt &,
+      theory_constantst &);
 };
 
 void output_expressions(
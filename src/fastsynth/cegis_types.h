@@ -3,6 +3,7 @@
 
 #include <set>
 #include <map>
+#include <vector>
 #include <solvers/smt2/smt2_parser.h>
 #include <util/std_expr.h>
 
@@ -12,6 +13,7 @@ public:
   std::set<exprt> free_variables;
   exprt::operandst side_conditions, constraints;
   std::set<constant_exprt> literals; /// Constant hints for solver.
+  std::vector<constant_exprt> lazy_literals; /// Added when learning fails.
   smt2_parsert::id_mapt id_map;
   std::set<irep_idt> synth_fun_set;
 };
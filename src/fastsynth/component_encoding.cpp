@@ -0,0 +1,375 @@
+#include "component_encoding.h"
+
+#include <util/arith_tools.h>
+#include <util/std_expr.h>
+#include <util/std_types.h>
+
+#include <algorithm>
+
+/// Reads the value of a location variable.
+/// \param solver Solver holding a satisfying assignment.
+/// \param location Location variable.
+/// \return Location, or 0 if the solver has no value for it.
+static std::size_t
+get_location(const decision_proceduret &solver, const exprt &location)
+{
+  const exprt value = solver.get(location);
+  mp_integer result;
+
+  if (value.id() != ID_constant || to_integer(to_constant_expr(value), result))
+    return 0;
+
+  return numeric_cast_v<std::size_t>(result);
+}
+
+typet c_datat::compute_word_type()
+{
+  typet result = return_type;
+
+  for (const auto &t : parameter_types)
+    result = promotion(result, t);
+
+  if (result.id() == ID_array || result.id() == ID_array_of)
+    return result.subtype();
+
+  return result;
+}
+
+exprt c_datat::location(std::size_t l) const
+{
+  return from_integer(l, location_type);
+}
+
+void c_datat::setup(
+    const function_application_exprt &e,
+    const std::size_t program_size,
+    const bool _enable_bitwise,
+    const bool _enable_division)
+{
+  if (setup_done)
+    return;
+  setup_done = true;
+
+  enable_bitwise = _enable_bitwise;
+  enable_division = _enable_division;
+
+  DATA_INVARIANT(e.function().id() == ID_symbol, "function must be symbol");
+  function_symbol = to_symbol_expr(e.function());
+  const std::string identifier = id2string(function_symbol.get_identifier());
+
+  return_type = e.type();
+
+  const auto &arguments = e.arguments();
+  parameter_types.resize(arguments.size());
+
+  for (std::size_t i = 0; i < parameter_types.size(); i++)
+  {
+    parameter_types[i] = arguments[i].type();
+
+    // there are no components that take arrays
+    if (arguments[i].type().id() != ID_array)
+      input_parameters.push_back(i);
+  }
+
+  word_type = compute_word_type();
+
+  for (auto it(begin(literals)); it != end(literals);)
+    if (word_type != it->type())
+      it = literals.erase(it);
+    else
+      ++it;
+
+  constant_val = symbol_exprt(identifier + "_cval", word_type);
+
+  // the library: program_size copies of each operation
+  const std::vector<irep_idt> operations =
+      binary_operations(
+          word_type, enable_bitwise, enable_division, false, operator_budget);
+
+  const std::size_t number_of_components =
+      program_size * operations.size();
+
+  const std::size_t locations = number_of_inputs() + number_of_components;
+
+  // one more value, to be able to state the upper bound
+  if (word_type.id() == ID_integer)
+    location_type = integer_typet();
+  else
+    location_type = unsignedbv_typet(
+        std::max(address_bits(locations + 1), std::size_t(1)));
+
+  components.reserve(number_of_components);
+
+  for (std::size_t copy = 0; copy < program_size; copy++)
+    for (const auto &operation : operations)
+    {
+      const std::string c_prefix =
+          identifier + "_c" + std::to_string(components.size());
+
+      components.push_back(componentt());
+      auto &component = components.back();
+      component.operation = operation;
+      component.output_location =
+          symbol_exprt(c_prefix + "_loc", location_type);
+
+      for (std::size_t k = 0; k < 2; k++)
+        component.input_locations.push_back(symbol_exprt(
+            c_prefix + "_in" + std::to_string(k) + "_loc", location_type));
+    }
+
+  result_location = symbol_exprt(identifier + "_result_loc", location_type);
+}
+
+void c_datat::well_formedness()
+{
+  const exprt first_output = location(number_of_inputs());
+  const exprt end_location = location(number_of_locations());
+  const bool unbounded = location_type.id() == ID_integer;
+  const exprt zero = location(0);
+
+  for (std::size_t j = 0; j < components.size(); j++)
+  {
+    const auto &component = components[j];
+    const symbol_exprt &output = component.output_location;
+
+    constraints.push_back(
+        binary_relation_exprt(output, ID_ge, first_output));
+    constraints.push_back(
+        binary_relation_exprt(output, ID_lt, end_location));
+
+    // inputs are taken from earlier locations, which rules out cycles
+    for (const auto &input : component.input_locations)
+    {
+      constraints.push_back(binary_relation_exprt(input, ID_lt, output));
+
+      if (unbounded)
+        constraints.push_back(binary_relation_exprt(input, ID_ge, zero));
+    }
+
+    // no need to have both orderings of the operands
+    if (is_commutative(component.operation))
+      constraints.push_back(binary_relation_exprt(
+          component.input_locations[0], ID_le,
+          component.input_locations[1]));
+
+    for (std::size_t i = 0; i < j; i++)
+    {
+      const auto &other = components[i];
+
+      // copies of the same operation are interchangeable,
+      // so fix their order
+      if (other.operation == component.operation)
+        constraints.push_back(
+            binary_relation_exprt(other.output_location, ID_lt, output));
+      else
+        constraints.push_back(notequal_exprt(other.output_location, output));
+    }
+  }
+
+  constraints.push_back(
+      binary_relation_exprt(result_location, ID_lt, end_location));
+
+  if (unbounded)
+    constraints.push_back(
+        binary_relation_exprt(result_location, ID_ge, zero));
+}
+
+exprt c_datat::result(const argumentst &arguments)
+{
+  constraints.clear();
+
+  if (instances.empty())
+    well_formedness();
+
+  const auto res = instances.emplace(arguments, instances.size());
+
+  const std::string prefix = id2string(function_symbol.get_identifier()) +
+                             "_inst" + std::to_string(res.first->second);
+
+  const symbol_exprt result_value(prefix + "_result", word_type);
+
+  // an instance seen before has already been constrained
+  if (!res.second)
+    return promotion(result_value, return_type);
+
+  // values at the input locations
+  std::vector<exprt> inputs;
+  inputs.reserve(number_of_inputs());
+
+  for (const auto p : input_parameters)
+    inputs.push_back(promotion(arguments[p], word_type));
+
+  for (const auto &l : literals)
+    inputs.push_back(l);
+
+  inputs.push_back(constant_val);
+
+  // values of the components
+  std::vector<symbol_exprt> outputs;
+  std::vector<std::vector<symbol_exprt>> operands;
+  outputs.reserve(components.size());
+  operands.reserve(components.size());
+
+  for (std::size_t j = 0; j < components.size(); j++)
+  {
+    const auto &component = components[j];
+    const std::string c_prefix = prefix + "_c" + std::to_string(j);
+
+    outputs.push_back(symbol_exprt(c_prefix + "_out", word_type));
+    operands.emplace_back();
+
+    for (std::size_t k = 0; k < component.input_locations.size(); k++)
+      operands.back().push_back(
+          symbol_exprt(c_prefix + "_in" + std::to_string(k), word_type));
+
+    constraints.push_back(equal_exprt(
+        outputs.back(),
+        binary_operation(
+            component.operation,
+            operands.back()[0],
+            operands.back()[1],
+            word_type)));
+  }
+
+  // a value equals whatever is at its location
+  auto connect = [&](const symbol_exprt &loc, const exprt &value) {
+    for (std::size_t l = 0; l < inputs.size(); l++)
+      constraints.push_back(implies_exprt(
+          equal_exprt(loc, location(l)), equal_exprt(value, inputs[l])));
+
+    for (std::size_t j = 0; j < components.size(); j++)
+      constraints.push_back(implies_exprt(
+          equal_exprt(loc, components[j].output_location),
+          equal_exprt(value, outputs[j])));
+  };
+
+  for (std::size_t j = 0; j < components.size(); j++)
+    for (std::size_t k = 0; k < operands[j].size(); k++)
+      connect(components[j].input_locations[k], operands[j][k]);
+
+  connect(result_location, result_value);
+
+  return promotion(result_value, return_type);
+}
+
+exprt c_datat::get_function(
+    const decision_proceduret &solver,
+    bool constant_variables) const
+{
+  std::vector<exprt> values;
+  values.resize(number_of_locations(), nil_exprt());
+
+  std::size_t l = 0;
+
+  for (const auto p : input_parameters)
+  {
+    irep_idt p_identifier = "synth::parameter" + std::to_string(p);
+    values[l++] =
+        promotion(symbol_exprt(p_identifier, parameter_types[p]), word_type);
+  }
+
+  for (const auto &literal : literals)
+    values[l++] = literal;
+
+  if (constant_variables)
+    values[l++] = constant_val;
+  else
+    values[l++] = solver.get(constant_val);
+
+  // build the components in the order of their locations
+  std::map<std::size_t, std::size_t> by_location;
+
+  for (std::size_t j = 0; j < components.size(); j++)
+    by_location[get_location(solver, components[j].output_location)] = j;
+
+  for (const auto &entry : by_location)
+  {
+    const auto &component = components[entry.second];
+
+    const std::size_t in0 = get_location(solver, component.input_locations[0]);
+    const std::size_t in1 = get_location(solver, component.input_locations[1]);
+
+    INVARIANT(
+        entry.first < values.size() && in0 < entry.first && in1 < entry.first,
+        "component locations must be well-formed");
+
+    values[entry.first] = binary_operation(
+        component.operation, values[in0], values[in1], word_type);
+  }
+
+  const std::size_t result = get_location(solver, result_location);
+
+  INVARIANT(
+      result < values.size() && values[result].is_not_nil(),
+      "result location must be well-formed");
+
+  return promotion(values[result], return_type);
+}
+
+exprt component_encodingt::function_application(
+    const function_application_exprt &expr)
+{
+  DATA_INVARIANT(expr.function().id() == ID_symbol, "function must be symbol");
+  c_datat &c_data = c_data_map[to_symbol_expr(expr.function())];
+
+  if (c_data.word_type.id().empty())
+    c_data.literals = literals;
+
+  c_data.operator_budget = operator_budget;
+
+  exprt final_result = c_data(
+      expr,
+      program_size,
+      enable_bitwise,
+      enable_division);
+
+  for (const auto &c : c_data.constraints)
+    constraints.push_back(c);
+
+  return final_result;
+}
+
+solutiont component_encodingt::get_solution(
+    const decision_proceduret &solver) const
+{
+  solutiont result;
+
+  for (const auto &it : c_data_map)
+  {
+    result.functions[it.first] =
+        it.second.get_function(solver, false);
+
+    result.s_functions[it.first] =
+        it.second.get_function(solver, true);
+  }
+
+  return result;
+}
+
+std::vector<symbol_exprt> component_encodingt::program_variables() const
+{
+  std::vector<symbol_exprt> result;
+
+  for (const auto &it : c_data_map)
+  {
+    const c_datat &c_data = it.second;
+
+    result.push_back(c_data.constant_val);
+    result.push_back(c_data.result_location);
+
+    for (const auto &component : c_data.components)
+    {
+      result.push_back(component.output_location);
+
+      for (const auto &input_location : component.input_locations)
+        result.push_back(input_location);
+    }
+  }
+
+  return result;
+}
+
+bool component_encodingt::grow(std::size_t)
+{
+  return false;
+}
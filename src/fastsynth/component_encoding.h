@@ -0,0 +1,126 @@
+#ifndef CPROVER_FASTSYNTH_COMPONENT_ENCODING_H_
+#define CPROVER_FASTSYNTH_COMPONENT_ENCODING_H_
+
+#include "synth_encoding.h"
+
+/// Component-based encoding of a single function: every operator of the
+/// library is instantiated a fixed number of times, and location
+/// variables decide how the components are wired together.
+/// Locations 0 to number_of_inputs-1 hold the parameters, the literals
+/// and the constant; component outputs are placed after those.
+struct c_datat
+{
+public:
+  c_datat() : enable_bitwise(false),
+              enable_division(false),
+              operator_budget(1u),
+              setup_done(false) {}
+
+  exprt operator()(
+      const function_application_exprt &expr,
+      const std::size_t program_size,
+      bool enable_bitwise,
+      bool enable_division)
+  {
+    setup(expr, program_size, enable_bitwise, enable_division);
+    return result(expr.arguments());
+  }
+
+  struct componentt
+  {
+    irep_idt operation;
+    symbol_exprt output_location = symbol_exprt::typeless(ID_empty_string);
+    std::vector<symbol_exprt> input_locations;
+  };
+
+  std::vector<componentt> components;
+
+  /// Location the function result is taken from.
+  symbol_exprt result_location = symbol_exprt::typeless(ID_empty_string);
+
+  /// Constant, available as the last input.
+  symbol_exprt constant_val = symbol_exprt::typeless(ID_empty_string);
+
+  symbol_exprt function_symbol = symbol_exprt::typeless(ID_empty_string);
+  std::vector<typet> parameter_types;
+  typet return_type;
+  typet word_type;
+  typet location_type;
+
+  /// Parameters that can be used as inputs, by input location.
+  std::vector<std::size_t> input_parameters;
+
+  std::size_t number_of_inputs() const
+  {
+    return input_parameters.size() + literals.size() + 1;
+  }
+
+  std::size_t number_of_locations() const
+  {
+    return number_of_inputs() + components.size();
+  }
+
+  exprt get_function(const decision_proceduret &,
+                     bool symbolic_constants) const;
+
+  using constraintst = std::list<exprt>;
+  constraintst constraints;
+
+  typet compute_word_type();
+
+  using argumentst =
+      function_application_exprt::argumentst;
+
+  using instancest =
+      std::unordered_map<argumentst, std::size_t, argumentst_hash>;
+  instancest instances;
+
+  bool enable_bitwise;
+  bool enable_division;
+
+  /// \see e_datat::operator_budget
+  std::size_t operator_budget;
+
+  /// Pre-configured constants to include in the expression set.
+  std::set<constant_exprt> literals;
+
+protected:
+  bool setup_done;
+
+  exprt location(std::size_t) const;
+
+  /// Constraints on the locations, shared by all instances.
+  void well_formedness();
+
+  exprt result(const argumentst &);
+
+  void setup(
+      const function_application_exprt &,
+      const std::size_t program_size,
+      const bool enable_bitwise,
+      const bool enable_division);
+};
+
+/// Synthesis encoding using c_datat instead of e_datat.
+/// The program size is the number of copies of each operator.
+class component_encodingt : public synth_encodingt
+{
+public:
+  solutiont get_solution(const decision_proceduret &) const override;
+
+  /// The constants and the locations of the components and the result.
+  /// The name of a component only depends on its copy and operator,
+  /// but the width of the locations grows with the library.
+  std::vector<symbol_exprt> program_variables() const override;
+
+  /// The library depends on the program size, so components cannot be
+  /// added to an existing encoding.
+  bool grow(std::size_t) override;
+
+protected:
+  std::map<symbol_exprt, c_datat> c_data_map;
+
+  exprt function_application(const function_application_exprt &) override;
+};
+
+#endif /* CPROVER_FASTSYNTH_COMPONENT_ENCODING_H_ */
@@ -0,0 +1,14 @@
+#include "component_learn.h"
+#include "component_encoding.h"
+
+component_learnt::component_learnt(
+    const namespacet &_ns,
+    const problemt &_problem,
+    message_handlert &_message_handler) : solver_learnt(_ns, _problem, _message_handler)
+{
+}
+
+std::unique_ptr<synth_encodingt> component_learnt::new_encoding() const
+{
+  return std::unique_ptr<synth_encodingt>(new component_encodingt());
+}
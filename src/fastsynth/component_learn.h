@@ -0,0 +1,24 @@
+#ifndef CPROVER_FASTSYNTH_COMPONENT_LEARN_H_
+#define CPROVER_FASTSYNTH_COMPONENT_LEARN_H_
+
+#include "solver_learn.h"
+
+/// Non-incremental learner using the component-based encoding.
+/// The program size is the number of copies of each operator.
+class component_learnt:public solver_learnt
+{
+public:
+  /// Creates a component-based learner.
+  /// \param msg \see msg solver_learnt::msg
+  /// \param ns \see ns solver_learnt::ns
+  /// \param problem \see solver_learnt::problem
+  component_learnt(
+    const namespacet &,
+    const problemt &,
+    message_handlert &);
+
+protected:
+  std::unique_ptr<synth_encodingt> new_encoding() const override;
+};
+
+#endif /* CPROVER_FASTSYNTH_COMPONENT_LEARN_H_ */
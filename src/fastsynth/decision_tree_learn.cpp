@@ -0,0 +1,329 @@
+#include "decision_tree_learn.h"
+#include "synth_encoding.h"
+
+#include <util/simplify_expr.h>
+
+#include <algorithm>
+
+decision_tree_learnt::decision_tree_learnt(
+    const namespacet &_ns,
+    const problemt &_problem,
+    message_handlert &_message_handler) : enumerative_learnt(_ns, _problem, _message_handler),
+                                          predicate_term_size(3u),
+                                          max_predicates(10000u)
+{
+}
+
+bool decision_tree_learnt::single_invocation()
+{
+  std::map<irep_idt, std::size_t> point_numbers;
+  for (std::size_t point = 0; point < points.size(); point++)
+    point_numbers[point_symbol(point).get_identifier()] = point;
+
+  specification_points.clear();
+
+  for (const auto &specification : specifications)
+  {
+    std::set<std::size_t> mentioned;
+
+    for (auto it(specification.depth_cbegin());
+         it != specification.depth_cend();
+         ++it)
+    {
+      if (it->id() != ID_symbol)
+        continue;
+
+      const auto p_it =
+          point_numbers.find(to_symbol_expr(*it).get_identifier());
+
+      if (p_it != point_numbers.end())
+        mentioned.insert(p_it->second);
+    }
+
+    if (mentioned.size() > 1)
+      return false;
+
+    specification_points.push_back(
+        mentioned.empty() ? points.size() : *mentioned.begin());
+  }
+
+  return true;
+}
+
+bool decision_tree_learnt::accept(const termt &term)
+{
+  std::vector<bool> holds;
+
+  if (check(term, &holds))
+  {
+    set_solution(term.expr);
+    return true;
+  }
+
+  pointst cover(points.size(), true);
+
+  for (std::size_t i = 0; i < holds.size(); i++)
+    if (!holds[i] && specification_points[i] < points.size())
+      cover[specification_points[i]] = false;
+
+  bool any = false;
+  for (const auto p : cover)
+    any = any || p;
+
+  if (any && seen_covers.insert(cover).second)
+  {
+    for (std::size_t point = 0; point < points.size(); point++)
+      covered[point] = covered[point] || cover[point];
+
+    covers.push_back(covert());
+    covers.back().expr = term.expr;
+    covers.back().points = std::move(cover);
+  }
+
+  // keep enumerating, there may be better covers of the same size
+  return false;
+}
+
+decision_tree_learnt::pointst decision_tree_learnt::relation(
+    const irep_idt &id,
+    const termt &t0,
+    const termt &t1)
+{
+  pointst result(points.size());
+
+  if (use_batch)
+  {
+    lanest lanes(points.size());
+    relation_programs[id](
+        {t0.lanes.data(), t1.lanes.data()}, points.size(), lanes.data());
+
+    for (std::size_t point = 0; point < points.size(); point++)
+      result[point] = lanes[point] != 0;
+  }
+  else
+  {
+    for (std::size_t point = 0; point < points.size(); point++)
+      result[point] =
+          simplify_expr(
+              binary_relation_exprt(t0.values[point], id, t1.values[point]),
+              ns)
+              .is_true();
+  }
+
+  return result;
+}
+
+void decision_tree_learnt::build_predicates()
+{
+  predicates.clear();
+  std::set<pointst> seen_predicates;
+
+  std::vector<const termt *> candidates;
+
+  for (std::size_t size = 1;
+       size <= predicate_term_size && size < terms.size();
+       size++)
+  {
+    for (const auto &term : terms[size])
+      candidates.push_back(&term);
+  }
+
+  auto add = [&](const exprt &expr, pointst values) {
+    // predicates that do not split anything are of no use
+    bool any_true = false, any_false = false;
+    for (const auto v : values)
+    {
+      any_true = any_true || v;
+      any_false = any_false || !v;
+    }
+
+    if (any_true && any_false &&
+        predicates.size() < max_predicates &&
+        seen_predicates.insert(values).second)
+    {
+      predicates.push_back(predicatet());
+      predicates.back().expr = expr;
+      predicates.back().values = std::move(values);
+    }
+  };
+
+  if (word_type.id() == ID_bool)
+  {
+    for (const auto *term : candidates)
+    {
+      pointst values(points.size());
+
+      for (std::size_t point = 0; point < points.size(); point++)
+        values[point] = use_batch ? term->lanes[point] != 0
+                                  : term->values[point].is_true();
+
+      add(term->expr, std::move(values));
+    }
+
+    return;
+  }
+
+  static const irep_idt relations[] = {ID_le, ID_lt, ID_equal};
+
+  for (std::size_t i = 0; i < candidates.size(); i++)
+    for (std::size_t j = 0; j < candidates.size(); j++)
+    {
+      if (i == j)
+        continue;
+
+      for (const auto &id : relations)
+      {
+        // equality is symmetric
+        if (id == ID_equal && j < i)
+          continue;
+
+        add(
+            binary_relation_exprt(candidates[i]->expr, id, candidates[j]->expr),
+            relation(id, *candidates[i], *candidates[j]));
+      }
+    }
+}
+
+std::size_t
+decision_tree_learnt::best_cover(const std::vector<std::size_t> &subset) const
+{
+  std::size_t best = 0;
+
+  for (const auto &cover : covers)
+  {
+    std::size_t count = 0;
+    for (const auto point : subset)
+      if (cover.points[point])
+        count++;
+
+    best = std::max(best, count);
+  }
+
+  return best;
+}
+
+bool decision_tree_learnt::learn_tree(
+    const std::vector<std::size_t> &subset,
+    exprt &result)
+{
+  // a single term will do
+  for (const auto &cover : covers)
+  {
+    bool all = true;
+    for (const auto point : subset)
+      all = all && cover.points[point];
+
+    if (all)
+    {
+      result = cover.expr;
+      return true;
+    }
+  }
+
+  // pick the predicate after which the fewest points are left uncovered
+  std::size_t best_score = 0;
+  const predicatet *best = nullptr;
+  std::vector<std::size_t> best_true, best_false;
+
+  for (const auto &predicate : predicates)
+  {
+    std::vector<std::size_t> true_points, false_points;
+
+    for (const auto point : subset)
+    {
+      if (predicate.values[point])
+        true_points.push_back(point);
+      else
+        false_points.push_back(point);
+    }
+
+    if (true_points.empty() || false_points.empty())
+      continue;
+
+    const std::size_t score = best_cover(true_points) + best_cover(false_points);
+
+    if (score > best_score)
+    {
+      best_score = score;
+      best = &predicate;
+      best_true.swap(true_points);
+      best_false.swap(false_points);
+    }
+  }
+
+  if (best == nullptr)
+    return false;
+
+  exprt then_expr, else_expr;
+
+  if (!learn_tree(best_true, then_expr) || !learn_tree(best_false, else_expr))
+    return false;
+
+  result = if_exprt(best->expr, then_expr, else_expr);
+  return true;
+}
+
+decision_proceduret::resultt decision_tree_learnt::operator()()
+{
+  setup();
+
+  if (!supported || specifications.empty() || !single_invocation())
+    return enumerative_learnt::operator()();
+
+  // specifications that do not mention the function hold for all terms
+  // or for none
+  for (std::size_t i = 0; i < specifications.size(); i++)
+    if (specification_points[i] == points.size() &&
+        !simplify_expr(specifications[i], ns).is_true())
+    {
+      return decision_proceduret::resultt::D_UNSATISFIABLE;
+    }
+
+  const std::size_t max_size = 2 * program_size - 1;
+  reset_terms(max_size);
+
+  covers.clear();
+  seen_covers.clear();
+  covered.assign(points.size(), false);
+
+  if (use_batch && word_type.id() != ID_bool && relation_programs.empty())
+  {
+    const symbol_exprt op0("enumerative::op0", word_type);
+    const symbol_exprt op1("enumerative::op1", word_type);
+
+    for (const auto &id : {ID_le, ID_lt, ID_equal})
+      relation_programs[id].compile(
+          binary_relation_exprt(op0, id, op1), {op0, op1});
+  }
+
+  std::vector<std::size_t> all_points;
+  for (std::size_t point = 0; point < points.size(); point++)
+    all_points.push_back(point);
+
+  for (std::size_t size = 1; size <= max_size; size++)
+  {
+    if (enumerate(size))
+      return decision_proceduret::resultt::D_SATISFIABLE;
+
+    bool all_covered = true;
+    for (const auto c : covered)
+      all_covered = all_covered && c;
+
+    if (!all_covered)
+      continue;
+
+    build_predicates();
+
+    exprt tree;
+
+    if (learn_tree(all_points, tree))
+    {
+      statistics() << "Decision tree over " << covers.size() << " terms and "
+                   << predicates.size() << " predicates" << eom;
+      set_solution(tree);
+      return decision_proceduret::resultt::D_SATISFIABLE;
+    }
+  }
+
+  return decision_proceduret::resultt::D_UNSATISFIABLE;
+}
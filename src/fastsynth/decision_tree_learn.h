@@ -0,0 +1,84 @@
+#ifndef CPROVER_FASTSYNTH_DECISION_TREE_LEARN_H_
+#define CPROVER_FASTSYNTH_DECISION_TREE_LEARN_H_
+
+#include "enumerative_learn.h"
+
+/// Divide-and-conquer learner: enumerates terms until every point is
+/// covered by some term, then learns a decision tree over enumerated
+/// predicates that selects a covering term for each point.
+/// The result is a nest of if-then-else over the terms.
+/// Requires every constraint to mention the function at a single point
+/// (single invocation); otherwise behaves like enumerative_learnt.
+class decision_tree_learnt:public enumerative_learnt
+{
+public:
+  /// Creates a decision-tree learner.
+  /// \param ns Namespace for simplification.
+  /// \param problem Synthesis problem to solve.
+  /// \param message_handler Message handler.
+  decision_tree_learnt(
+    const namespacet &,
+    const problemt &,
+    message_handlert &);
+
+  /// \see learnt::operator()()
+  decision_proceduret::resultt operator()() override;
+
+  /// Predicates are built from terms with at most this many nodes.
+  std::size_t predicate_term_size;
+
+  /// Maximum number of predicates considered.
+  std::size_t max_predicates;
+
+protected:
+  using pointst = std::vector<bool>;
+
+  struct covert
+  {
+    exprt expr;
+    pointst points;
+  };
+
+  struct predicatet
+  {
+    exprt expr;
+    pointst values;
+  };
+
+  /// Terms with distinct, non-empty sets of covered points.
+  std::vector<covert> covers;
+  std::set<pointst> seen_covers;
+
+  /// Union of all covers.
+  pointst covered;
+
+  std::vector<predicatet> predicates;
+
+  /// The point each specification mentions, or points.size() if none.
+  std::vector<std::size_t> specification_points;
+
+  /// Relations used in predicates, compiled over two word operands.
+  std::map<irep_idt, batch_evaluatort> relation_programs;
+
+  /// Records the points covered by the term.
+  bool accept(const termt &) override;
+
+  /// Determines specification_points.
+  /// \return False if a specification mentions several points.
+  bool single_invocation();
+
+  /// Builds predicates from the enumerated terms.
+  void build_predicates();
+
+  /// Values of a relation between two terms at all points.
+  pointst relation(const irep_idt &, const termt &, const termt &);
+
+  /// Learns a decision tree for the given points.
+  /// \return False if the predicates cannot separate the points.
+  bool learn_tree(const std::vector<std::size_t> &, exprt &);
+
+  /// Largest number of the given points covered by a single term.
+  std::size_t best_cover(const std::vector<std::size_t> &) const;
+};
+
+#endif /* CPROVER_FASTSYNTH_DECISION_TREE_LEARN_H_ */
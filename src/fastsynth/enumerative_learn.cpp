@@ -0,0 +1,639 @@
+#include "enumerative_learn.h"
+#include "synth_encoding.h"
+
+#include <util/arith_tools.h>
+#include <util/expr_util.h>
+#include <util/replace_expr.h>
+#include <util/simplify_expr.h>
+
+#include <algorithm>
+
+enumerative_learnt::enumerative_learnt(
+    const namespacet &_ns,
+    const problemt &_problem,
+    message_handlert &_message_handler) : learnt(_message_handler),
+                                          ns(_ns),
+                                          problem(_problem),
+                                          program_size(1u),
+                                          use_batch(false),
+                                          batch_check(false),
+                                          instances(0u),
+                                          setup_done(false),
+                                          literal_count(0u),
+                                          supported(true)
+{
+}
+
+void enumerative_learnt::set_program_size(const size_t program_size)
+{
+  this->program_size = program_size;
+}
+
+void enumerative_learnt::set_array_size(const size_t)
+{
+}
+
+void enumerative_learnt::setup()
+{
+  if (setup_done)
+  {
+    // literals may have been added lazily
+    if (literal_count != problem.literals.size())
+      setup_literals();
+    return;
+  }
+  setup_done = true;
+
+  std::set<symbol_exprt> functions;
+
+  for (const auto *container : {&problem.side_conditions, &problem.constraints})
+    for (const exprt &e : *container)
+      for (auto it(e.depth_cbegin()); it != e.depth_cend(); ++it)
+      {
+        if (it->id() != ID_function_application)
+          continue;
+
+        const auto &application = to_function_application_expr(*it);
+
+        for (const auto &argument : application.arguments())
+          if (has_subexpr(argument, ID_function_application))
+            supported = false;
+
+        if (functions.insert(to_symbol_expr(application.function())).second)
+        {
+          function_symbol = to_symbol_expr(application.function());
+          return_type = application.type();
+          parameter_types.clear();
+          for (const auto &argument : application.arguments())
+            parameter_types.push_back(argument.type());
+        }
+      }
+
+  if (functions.size() != 1)
+    supported = false;
+
+  // same word type as e_datat
+  word_type = return_type;
+
+  for (const auto &t : parameter_types)
+  {
+    if (t.id() == ID_array)
+      supported = false;
+    word_type = promotion(word_type, t);
+  }
+
+  if (return_type.id() == ID_array)
+    supported = false;
+
+  operations = binary_operations(
+      word_type, enable_bitwise, false, false, operator_budget);
+
+  setup_literals();
+
+  if (supported)
+    setup_batch();
+}
+
+void enumerative_learnt::setup_literals()
+{
+  std::set<constant_exprt> literal_set;
+
+  for (const auto &l : problem.literals)
+    if (l.type() == word_type)
+      literal_set.insert(l);
+
+  if (word_type.id() == ID_bool)
+  {
+    literal_set.insert(true_exprt());
+    literal_set.insert(false_exprt());
+  }
+  else if (word_type.id() == ID_unsignedbv ||
+           word_type.id() == ID_signedbv ||
+           word_type.id() == ID_integer)
+  {
+    literal_set.insert(from_integer(0, word_type));
+    literal_set.insert(from_integer(1, word_type));
+  }
+
+  literals.assign(literal_set.begin(), literal_set.end());
+  literal_count = problem.literals.size();
+}
+
+void enumerative_learnt::setup_batch()
+{
+  use_batch = batch_evaluatort::is_supported(word_type) &&
+              batch_evaluatort::is_supported(return_type);
+
+  for (const auto &t : parameter_types)
+    if (!batch_evaluatort::is_supported(t))
+      use_batch = false;
+
+  const symbol_exprt op0("enumerative::op0", word_type);
+  const symbol_exprt op1("enumerative::op1", word_type);
+
+  for (const auto &operation : operations)
+    if (use_batch &&
+        !operation_programs[operation].compile(
+            binary_operation(operation, op0, op1, word_type), {op0, op1}))
+    {
+      use_batch = false;
+    }
+
+  if (use_batch)
+    use_batch =
+        promotion_program.compile(promotion(op0, return_type), {op0});
+
+  batch_check = use_batch && compile_constraints();
+
+  if (!batch_check)
+    constraint_programs.clear();
+}
+
+bool enumerative_learnt::compile_constraints()
+{
+  variables.assign(
+      problem.free_variables.begin(), problem.free_variables.end());
+  variable_lanes.assign(variables.size(), lanest());
+
+  for (const auto *container : {&problem.side_conditions, &problem.constraints})
+    for (const exprt &e : *container)
+    {
+      constraint_programs.push_back(constraint_programt());
+      constraint_programt &constraint = constraint_programs.back();
+
+      const exprt abstracted =
+          abstract_applications(e, constraint.applications);
+
+      std::vector<exprt> inputs = variables;
+      for (std::size_t i = 0; i < constraint.applications.size(); i++)
+        inputs.push_back(symbol_exprt(
+            "enumerative::application" + std::to_string(i),
+            constraint.applications[i].type()));
+
+      constraint.points.resize(constraint.applications.size());
+
+      if (!constraint.program.compile(abstracted, inputs))
+        return false;
+    }
+
+  return true;
+}
+
+bool enumerative_learnt::add_instance(const replace_mapt &assignment)
+{
+  for (std::size_t v = 0; v < variables.size(); v++)
+  {
+    const auto it = assignment.find(variables[v]);
+
+    if (it == assignment.end())
+      return false;
+
+    const exprt value = simplify_expr(it->second, ns);
+
+    if (!value.is_constant())
+      return false;
+
+    variable_lanes[v].push_back(batch_evaluatort::to_lane(value));
+  }
+
+  for (auto &constraint : constraint_programs)
+    for (std::size_t i = 0; i < constraint.applications.size(); i++)
+    {
+      // as in abstract_applications(const exprt &)
+      argumentst arguments =
+          to_function_application_expr(constraint.applications[i])
+              .arguments();
+
+      for (auto &argument : arguments)
+      {
+        replace_expr(assignment, argument);
+        argument = simplify_expr(argument, ns);
+      }
+
+      const auto res = point_numbers.emplace(arguments, points.size());
+
+      if (res.second)
+        points.push_back(arguments);
+
+      constraint.points[i].push_back(res.first->second);
+    }
+
+  instances++;
+  return true;
+}
+
+bool enumerative_learnt::compute_parameter_lanes()
+{
+  parameter_lanes.assign(parameter_types.size(), lanest());
+
+  for (std::size_t i = 0; i < parameter_types.size(); i++)
+  {
+    parameter_lanes[i].reserve(points.size());
+
+    for (const auto &point : points)
+    {
+      const exprt value = simplify_expr(promotion(point[i], word_type), ns);
+
+      if (!value.is_constant())
+        return false;
+
+      parameter_lanes[i].push_back(batch_evaluatort::to_lane(value));
+    }
+  }
+
+  return true;
+}
+
+symbol_exprt enumerative_learnt::point_symbol(std::size_t point) const
+{
+  return symbol_exprt(
+      "enumerative::point" + std::to_string(point), return_type);
+}
+
+exprt enumerative_learnt::abstract_applications(const exprt &expr)
+{
+  if (expr.id() == ID_function_application)
+  {
+    argumentst arguments = to_function_application_expr(expr).arguments();
+
+    for (auto &argument : arguments)
+      argument = simplify_expr(argument, ns);
+
+    const auto res = point_numbers.emplace(arguments, points.size());
+
+    if (res.second)
+      points.push_back(arguments);
+
+    return point_symbol(res.first->second);
+  }
+
+  exprt tmp = expr;
+
+  for (auto &op : tmp.operands())
+    op = abstract_applications(op);
+
+  return tmp;
+}
+
+exprt enumerative_learnt::abstract_applications(
+    const exprt &expr,
+    std::vector<exprt> &applications)
+{
+  if (expr.id() == ID_function_application)
+  {
+    const std::size_t number =
+        std::find(applications.begin(), applications.end(), expr) -
+        applications.begin();
+
+    if (number == applications.size())
+      applications.push_back(expr);
+
+    return symbol_exprt(
+        "enumerative::application" + std::to_string(number), expr.type());
+  }
+
+  exprt tmp = expr;
+
+  for (auto &op : tmp.operands())
+    op = abstract_applications(op, applications);
+
+  return tmp;
+}
+
+void enumerative_learnt::add_ce(const counterexamplet &counterexample)
+{
+  setup();
+
+  if (!supported)
+    return;
+
+  replace_mapt assignment;
+
+  for (const auto &it : counterexample.assignment)
+    assignment[it.first] = it.second;
+
+  for (const auto *container : {&problem.side_conditions, &problem.constraints})
+    for (const exprt &e : *container)
+    {
+      exprt instance = e;
+      replace_expr(assignment, instance);
+      specifications.push_back(
+          simplify_expr(abstract_applications(instance), ns));
+    }
+
+  if (batch_check && !add_instance(assignment))
+    batch_check = false;
+
+  if (!batch_check)
+    constraint_programs.clear();
+}
+
+bool enumerative_learnt::add_term(
+    std::size_t size,
+    const exprt &expr,
+    valuest values,
+    lanest lanes)
+{
+  if (use_batch ? !seen_lanes.insert(lanes).second
+                : !seen.insert(values).second)
+  {
+    return false;
+  }
+
+  terms[size].push_back(termt());
+  terms[size].back().expr = expr;
+  terms[size].back().values = std::move(values);
+  terms[size].back().lanes = std::move(lanes);
+
+  return true;
+}
+
+bool enumerative_learnt::check(
+    const valuest &values,
+    std::vector<bool> *holds) const
+{
+  replace_mapt results;
+
+  for (std::size_t point = 0; point < values.size(); point++)
+    results[point_symbol(point)] =
+        simplify_expr(promotion(values[point], return_type), ns);
+
+  bool all = true;
+
+  for (std::size_t i = 0; i < specifications.size(); i++)
+  {
+    exprt tmp = specifications[i];
+    replace_expr(results, tmp);
+
+    const bool h = simplify_expr(tmp, ns).is_true();
+
+    if (holds != nullptr)
+      holds->push_back(h);
+    else if (!h)
+      return false;
+
+    all = all && h;
+  }
+
+  return all;
+}
+
+bool enumerative_learnt::check(const termt &term, std::vector<bool> *holds)
+{
+  if (holds != nullptr)
+    holds->clear();
+
+  if (!use_batch)
+    return check(term.values, holds);
+
+  const std::size_t count = term.lanes.size();
+
+  if (!batch_check)
+  {
+    valuest values;
+    values.reserve(count);
+    for (const auto lane : term.lanes)
+      values.push_back(batch_evaluatort::from_lane(lane, word_type));
+    return check(values, holds);
+  }
+
+  results.resize(count);
+  promotion_program({term.lanes.data()}, count, results.data());
+
+  holds_lanes.resize(constraint_programs.size() * instances);
+
+  bool all = true;
+
+  for (std::size_t c = 0; c < constraint_programs.size(); c++)
+  {
+    constraint_programt &constraint = constraint_programs[c];
+
+    std::vector<const std::uint64_t *> inputs;
+    inputs.reserve(variables.size() + constraint.applications.size());
+
+    for (const auto &lanes : variable_lanes)
+      inputs.push_back(lanes.data());
+
+    if (application_lanes.size() < constraint.applications.size())
+      application_lanes.resize(constraint.applications.size());
+
+    for (std::size_t i = 0; i < constraint.applications.size(); i++)
+    {
+      lanest &lanes = application_lanes[i];
+      lanes.resize(instances);
+
+      for (std::size_t j = 0; j < instances; j++)
+        lanes[j] = results[constraint.points[i][j]];
+
+      inputs.push_back(lanes.data());
+    }
+
+    std::uint64_t *h = holds_lanes.data() + c * instances;
+    constraint.program(inputs, instances, h);
+
+    for (std::size_t j = 0; j < instances; j++)
+      if (h[j] == 0)
+      {
+        if (holds == nullptr)
+          return false;
+
+        all = false;
+      }
+  }
+
+  // in the order of specifications
+  if (holds != nullptr)
+    for (std::size_t j = 0; j < instances; j++)
+      for (std::size_t c = 0; c < constraint_programs.size(); c++)
+        holds->push_back(holds_lanes[c * instances + j] != 0);
+
+  return all;
+}
+
+bool enumerative_learnt::accept(const termt &term)
+{
+  if (!check(term))
+    return false;
+
+  set_solution(term.expr);
+  return true;
+}
+
+bool enumerative_learnt::enumerate(std::size_t size)
+{
+  if (size == 1)
+  {
+    // parameters and literals
+    for (std::size_t i = 0; i < parameter_types.size(); i++)
+    {
+      irep_idt p_identifier = "synth::parameter" + std::to_string(i);
+      const exprt expr =
+          promotion(symbol_exprt(p_identifier, parameter_types[i]), word_type);
+
+      valuest values;
+      lanest lanes;
+
+      if (use_batch)
+        lanes = parameter_lanes[i];
+      else
+      {
+        values.reserve(points.size());
+
+        for (const auto &point : points)
+          values.push_back(simplify_expr(promotion(point[i], word_type), ns));
+      }
+
+      if (add_term(size, expr, std::move(values), std::move(lanes)) &&
+          accept(terms[size].back()))
+      {
+        return true;
+      }
+    }
+
+    for (const auto &literal : literals)
+    {
+      valuest values;
+      lanest lanes;
+
+      if (use_batch)
+        lanes.assign(points.size(), batch_evaluatort::to_lane(literal));
+      else
+        values.assign(points.size(), literal);
+
+      if (add_term(size, literal, std::move(values), std::move(lanes)) &&
+          accept(terms[size].back()))
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  for (const auto &operation : operations)
+  {
+    const bool commutative = is_commutative(operation);
+
+    for (std::size_t size0 = 1; size0 + 1 < size; size0++)
+    {
+      const std::size_t size1 = size - 1 - size0;
+
+      // no need to have both orderings
+      if (commutative && size0 > size1)
+        continue;
+
+      for (std::size_t i0 = 0; i0 < terms[size0].size(); i0++)
+        for (std::size_t i1 = 0; i1 < terms[size1].size(); i1++)
+        {
+          if (size0 == size1)
+          {
+            if (commutative && i0 > i1)
+              continue;
+
+            // as in e_datat, only ID_plus is applied to identical operands
+            if (i0 == i1 && operation != ID_plus)
+              continue;
+          }
+
+          const termt &t0 = terms[size0][i0];
+          const termt &t1 = terms[size1][i1];
+
+          valuest values;
+          lanest lanes;
+
+          if (use_batch)
+          {
+            lanes.resize(points.size());
+            operation_programs[operation](
+                {t0.lanes.data(), t1.lanes.data()},
+                points.size(),
+                lanes.data());
+          }
+          else
+          {
+            values.reserve(points.size());
+
+            for (std::size_t point = 0; point < points.size(); point++)
+              values.push_back(simplify_expr(
+                  binary_operation(
+                      operation, t0.values[point], t1.values[point], word_type),
+                  ns));
+          }
+
+          if (add_term(
+                  size,
+                  binary_operation(operation, t0.expr, t1.expr, word_type),
+                  std::move(values),
+                  std::move(lanes)) &&
+              accept(terms[size].back()))
+          {
+            return true;
+          }
+        }
+    }
+  }
+
+  return false;
+}
+
+void enumerative_learnt::set_solution(const exprt &expr)
+{
+  const exprt body = promotion(expr, return_type);
+
+  last_solution.functions.clear();
+  last_solution.s_functions.clear();
+  last_solution.functions[function_symbol] = body;
+  last_solution.s_functions[function_symbol] = body;
+}
+
+void enumerative_learnt::reset_terms(std::size_t max_size)
+{
+  if (use_batch && !compute_parameter_lanes())
+  {
+    use_batch = false;
+    batch_check = false;
+    constraint_programs.clear();
+  }
+
+  // the points may have changed, hence start from scratch
+  terms.clear();
+  seen.clear();
+  seen_lanes.clear();
+  terms.resize(max_size + 1);
+}
+
+decision_proceduret::resultt enumerative_learnt::operator()()
+{
+  setup();
+
+  if (!supported)
+  {
+    error() << "enumerative learner requires a single function "
+            << "without nested applications" << eom;
+    return decision_proceduret::resultt::D_ERROR;
+  }
+
+  const std::size_t max_size = 2 * program_size - 1;
+  reset_terms(max_size);
+
+  for (std::size_t size = 1; size <= max_size; size++)
+  {
+    if (enumerate(size))
+    {
+      statistics() << "Enumerated " << seen.size() + seen_lanes.size()
+                   << " distinct terms over "
+                   << points.size() << " points" << eom;
+      return decision_proceduret::resultt::D_SATISFIABLE;
+    }
+  }
+
+  statistics() << "Enumerated " << seen.size() + seen_lanes.size()
+               << " distinct terms over " << points.size() << " points" << eom;
+
+  return decision_proceduret::resultt::D_UNSATISFIABLE;
+}
+
+solutiont enumerative_learnt::get_solution() const
+{
+  return last_solution;
+}
@@ -0,0 +1,202 @@
+#ifndef CPROVER_FASTSYNTH_ENUMERATIVE_LEARN_H_
+#define CPROVER_FASTSYNTH_ENUMERATIVE_LEARN_H_
+
+#include "batch_evaluator.h"
+#include "learn.h"
+
+#include <util/namespace.h>
+#include <util/replace_expr.h>
+
+/// Enumerates expressions bottom-up by size, over the operators and
+/// literals of e_datat. Expressions that agree with an earlier one on all
+/// counterexamples are dropped (observational equivalence).
+/// Supports problems with a single function to synthesise, whose
+/// arguments do not contain applications.
+class enumerative_learnt:public learnt
+{
+public:
+  /// Creates an enumerative learner.
+  /// \param ns Namespace for simplification.
+  /// \param problem Synthesis problem to solve.
+  /// \param message_handler Message handler.
+  enumerative_learnt(
+    const namespacet &,
+    const problemt &,
+    message_handlert &);
+
+  /// \see learnt::set_program_size(size_t)
+  void set_program_size(size_t program_size) override;
+  void set_array_size(std::size_t array_size) override;
+
+  /// \see learnt::operator()()
+  decision_proceduret::resultt operator()() override;
+
+  /// \see learnt::get_solution()
+  solutiont get_solution() const override;
+
+  /// \see learnt::add_ce(const counterexamplet &)
+  void add_ce(const counterexamplet &) override;
+
+protected:
+  const namespacet &ns;
+  const problemt &problem;
+
+  /// Expressions have at most 2*program_size-1 nodes.
+  std::size_t program_size;
+
+  solutiont last_solution;
+
+  /// Values of an expression, one per point.
+  using valuest = std::vector<exprt>;
+
+  /// Bit patterns of the values, one lane per point.
+  using lanest = std::vector<std::uint64_t>;
+
+  /// A term has either values or lanes, depending on use_batch.
+  struct termt
+  {
+    exprt expr;
+    valuest values;
+    lanest lanes;
+  };
+
+  /// Observationally distinct terms found so far, by size.
+  std::vector<std::vector<termt>> terms;
+
+  /// Values of all terms found so far.
+  std::set<valuest> seen;
+  std::set<lanest> seen_lanes;
+
+  /// Whether terms are evaluated with batch_evaluatort, which requires
+  /// Boolean or bit-vector types of at most 64 bits.
+  bool use_batch;
+
+  /// Each operation, compiled over two operands of the word type.
+  std::map<irep_idt, batch_evaluatort> operation_programs;
+
+  /// Converts values of the word type to the return type.
+  batch_evaluatort promotion_program;
+
+  /// A side condition or constraint compiled once, over the free
+  /// variables followed by the results of its applications. Its
+  /// instances are checked at once, one lane per counterexample.
+  struct constraint_programt
+  {
+    batch_evaluatort program;
+
+    /// Applications of the function, in the order of the inputs.
+    std::vector<exprt> applications;
+
+    /// For each application, its point in each counterexample.
+    std::vector<std::vector<std::size_t>> points;
+  };
+
+  /// Compiled side conditions and constraints, in the order of the
+  /// specifications of a counterexample. Only used if all compile.
+  std::vector<constraint_programt> constraint_programs;
+  bool batch_check;
+
+  /// Free variables, in the order of the inputs of constraint_programs.
+  std::vector<exprt> variables;
+
+  /// Lanes of each free variable, one per counterexample.
+  std::vector<lanest> variable_lanes;
+
+  /// Number of counterexamples.
+  std::size_t instances;
+
+  /// Buffers of check(const termt &).
+  lanest results, holds_lanes;
+  std::vector<lanest> application_lanes;
+
+  /// Lanes of each parameter, as of the last call to operator().
+  std::vector<lanest> parameter_lanes;
+
+  bool setup_done;
+
+  /// Number of problem literals the literals were built from.
+  std::size_t literal_count;
+
+  /// False if the problem has a shape the learner cannot handle.
+  bool supported;
+
+  symbol_exprt function_symbol = symbol_exprt::typeless(ID_empty_string);
+  std::vector<typet> parameter_types;
+  typet return_type;
+  typet word_type;
+
+  /// Operations and literals to build terms from.
+  std::vector<irep_idt> operations;
+  std::vector<constant_exprt> literals;
+
+  using argumentst = exprt::operandst;
+
+  /// Arguments the function is applied to in the counterexamples.
+  std::vector<argumentst> points;
+  std::map<argumentst, std::size_t> point_numbers;
+
+  /// Side conditions and constraints instantiated with the
+  /// counterexamples. Applications are replaced by point_symbol().
+  std::vector<exprt> specifications;
+
+  void setup();
+
+  /// Sets up the literals from the problem literals.
+  void setup_literals();
+
+  /// Symbol standing for the result of the function at a point.
+  symbol_exprt point_symbol(std::size_t point) const;
+
+  /// Replaces the applications in an instantiated constraint by symbols
+  /// for their points.
+  exprt abstract_applications(const exprt &);
+
+  /// Replaces the applications in a side condition or constraint by
+  /// symbols for their position in \p applications, which receives
+  /// them.
+  exprt abstract_applications(const exprt &, std::vector<exprt> &applications);
+
+  /// Compiles the side conditions and constraints.
+  /// \return False if one does not compile.
+  bool compile_constraints();
+
+  /// Adds the lanes of a counterexample to constraint_programs.
+  /// \return False if a value is not a constant of a supported type.
+  bool add_instance(const replace_mapt &assignment);
+
+  /// Adds a term unless one with the same values exists.
+  /// \return True if the term was added.
+  bool add_term(std::size_t size, const exprt &, valuest, lanest);
+
+  /// Sets up the compiled programs for batch evaluation.
+  void setup_batch();
+
+  /// Computes the lanes of the parameters at the points.
+  /// \return False if an argument is not a constant.
+  bool compute_parameter_lanes();
+
+  /// Adds the terms of the given size.
+  /// \return True if a term satisfying all specifications was found.
+  bool enumerate(std::size_t size);
+
+  /// Checks whether the term given by its values satisfies the
+  /// specifications.
+  /// \param holds If given, receives for each specification whether it
+  ///   holds, and all specifications are evaluated.
+  /// \return True if all specifications hold.
+  bool check(const valuest &, std::vector<bool> *holds) const;
+  bool check(const termt &, std::vector<bool> *holds = nullptr);
+
+  /// Called for each new term.
+  /// \return True to stop the enumeration, with a solution set.
+  virtual bool accept(const termt &);
+
+  /// Discards the terms of an earlier call.
+  /// \param max_size Largest term size to be enumerated.
+  void reset_terms(std::size_t max_size);
+
+  /// Records the term as the solution.
+  void set_solution(const exprt &);
+};
+
+#endif /* CPROVER_FASTSYNTH_ENUMERATIVE_LEARN_H_ */
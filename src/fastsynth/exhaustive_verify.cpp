@@ -0,0 +1,150 @@
+#include "exhaustive_verify.h"
+#include "batch_evaluator.h"
+
+#include <util/std_types.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+const std::size_t exhaustive_verifyt::chunk_size;
+
+static std::size_t bits_of(const typet &type)
+{
+  if (type.id() == ID_bool)
+    return 1;
+
+  return to_bitvector_type(type).get_width();
+}
+
+decision_proceduret::resultt exhaustive_verifyt::operator()(
+    const solutiont &solution)
+{
+  const std::vector<exprt> variables(
+      problem.free_variables.begin(), problem.free_variables.end());
+
+  // the position of each variable within the assignment number
+  std::vector<std::size_t> offsets;
+  std::size_t bits = 0;
+
+  for (const auto &v : variables)
+  {
+    if (!batch_evaluatort::is_supported(v.type()))
+      return verifyt::operator()(solution);
+
+    offsets.push_back(bits);
+    bits += bits_of(v.type());
+  }
+
+  if (bits > max_bits)
+    return verifyt::operator()(solution);
+
+  verify_encodingt::check_function_bodies(solution.functions);
+
+  verify_encodingt verify_encoding;
+  verify_encoding.functions = solution.functions;
+  verify_encoding.free_variables = problem.free_variables;
+
+  // a violation satisfies the side conditions but not the constraints
+  exprt::operandst violation;
+
+  for (const auto &e : problem.side_conditions)
+    violation.push_back(verify_encoding(e));
+
+  violation.push_back(
+      not_exprt(verify_encoding(conjunction(problem.constraints))));
+
+  batch_evaluatort evaluator;
+
+  if (!evaluator.compile(conjunction(violation), variables))
+  {
+    debug() << "exhaustive verification not applicable" << eom;
+    return verifyt::operator()(solution);
+  }
+
+  const std::uint64_t space = std::uint64_t(1) << bits;
+  const std::uint64_t chunks = (space + chunk_size - 1) / chunk_size;
+
+  // the smallest violating assignment found so far, or space
+  std::atomic<std::uint64_t> first_violation(space);
+  std::atomic<std::uint64_t> next_chunk(0);
+
+  auto worker = [&](batch_evaluatort local_evaluator) {
+    std::vector<std::vector<std::uint64_t>> lanes(
+        variables.size(), std::vector<std::uint64_t>(chunk_size));
+    std::vector<const std::uint64_t *> inputs;
+    for (const auto &l : lanes)
+      inputs.push_back(l.data());
+    std::vector<std::uint64_t> result(chunk_size);
+
+    while (true)
+    {
+      const std::uint64_t chunk = next_chunk++;
+      const std::uint64_t start = chunk * chunk_size;
+
+      // chunks are handed out in order, so nothing later can be smaller
+      if (chunk >= chunks || start >= first_violation)
+        break;
+
+      const std::size_t count =
+          std::min<std::uint64_t>(chunk_size, space - start);
+
+      for (std::size_t v = 0; v < variables.size(); v++)
+      {
+        const std::uint64_t mask =
+            (std::uint64_t(1) << bits_of(variables[v].type())) - 1;
+
+        for (std::size_t i = 0; i < count; i++)
+          lanes[v][i] = ((start + i) >> offsets[v]) & mask;
+      }
+
+      local_evaluator(inputs, count, result.data());
+
+      for (std::size_t i = 0; i < count; i++)
+        if (result[i] != 0)
+        {
+          std::uint64_t current = first_violation;
+          while (start + i < current &&
+                 !first_violation.compare_exchange_weak(current, start + i))
+          {
+          }
+          break;
+        }
+    }
+  };
+
+  const std::size_t number_of_threads = std::max<std::size_t>(
+      1,
+      std::min<std::uint64_t>(std::thread::hardware_concurrency(), chunks));
+
+  std::vector<std::thread> threads;
+
+  for (std::size_t t = 1; t < number_of_threads; t++)
+    threads.push_back(std::thread(worker, evaluator));
+
+  worker(evaluator);
+
+  for (auto &thread : threads)
+    thread.join();
+
+  debug() << "exhaustive verification of " << space << " assignments on "
+          << number_of_threads << " threads" << eom;
+
+  counterexample.clear();
+
+  if (first_violation == space)
+    return decision_proceduret::resultt::D_UNSATISFIABLE;
+
+  const std::uint64_t assignment = first_violation;
+
+  for (std::size_t v = 0; v < variables.size(); v++)
+  {
+    const std::uint64_t mask =
+        (std::uint64_t(1) << bits_of(variables[v].type())) - 1;
+
+    counterexample.assignment[variables[v]] = batch_evaluatort::from_lane(
+        (assignment >> offsets[v]) & mask, variables[v].type());
+  }
+
+  return decision_proceduret::resultt::D_SATISFIABLE;
+}
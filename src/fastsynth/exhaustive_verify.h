@@ -0,0 +1,32 @@
+#ifndef CPROVER_FASTSYNTH_EXHAUSTIVE_VERIFY_H_
+#define CPROVER_FASTSYNTH_EXHAUSTIVE_VERIFY_H_
+
+#include "verify.h"
+
+/// Verifies a candidate by evaluating the problem on every assignment to
+/// the free variables, using batch_evaluatort on several threads.
+/// Falls back to verifyt if the input space has more than max_bits bits
+/// or the problem cannot be evaluated in batch.
+class exhaustive_verifyt:public verifyt
+{
+public:
+  exhaustive_verifyt(
+    const namespacet &_ns,
+    const problemt &_problem,
+    message_handlert &_message_handler):
+    verifyt(_ns, _problem, _message_handler),
+    max_bits(24)
+  {
+  }
+
+  /// \see verifyt::operator()(const solutiont &)
+  decision_proceduret::resultt operator()(const solutiont &) override;
+
+  /// Largest input space to enumerate, in bits.
+  std::size_t max_bits;
+
+  /// Number of assignments evaluated by a thread in one go.
+  static const std::size_t chunk_size = 1 << 12;
+};
+
+#endif /* CPROVER_FASTSYNTH_EXHAUSTIVE_VERIFY_H_ */
@@ -1,4 +1,5 @@
 #include <iostream>
+#include <stdexcept>
 
 #include <util/suffix.h>
 #include <util/cmdline.h>
@@ -6,15 +7,38 @@
 #include "c_frontend.h"
 #include "sygus_frontend.h"
 #include "smt2_frontend.h"
+#include "query_cache.h"
+#include "query_capture.h"
+#include "replay_frontend.h"
 
 #define FASTSYNTH_OPTIONS \
-  "(max-program-size):"   \
-  "(no-bitwise)"          \
-  "(verbosity):"          \
-  "(smt)"                 \
-  "(literals)"            \
-  "(enable-division)"     \
-  "(arrays)"
+  "(max-program-size):"    \
+  "(no-bitwise)"           \
+  "(verbosity):"           \
+  "(smt)"                  \
+  "(literals)"             \
+  "(max-literals):"        \
+  "(lazy-literals)"        \
+  "(enable-division)"      \
+  "(arrays)"               \
+  "(width-scaling):"       \
+  "(learner):"             \
+  "(exhaustive-verify)"    \
+  "(parallel-verify)"      \
+  "(verify-jobs):"         \
+  "(sat-solver):"          \
+  "(learner-sat-solver):"  \
+  "(verifier-sat-solver):" \
+  "(sat-portfolio):"       \
+  "(query-cache):"         \
+  "(query-cache-size):"    \
+  "(capture-queries):"     \
+  "(replay-queries)"       \
+  "(replay-role):"         \
+  "(smt-solver):"          \
+  "(cegis-t)"              \
+  "(fm)"                   \
+  "(operator-budget):"
 
 int main(int argc, const char *argv[])
 {
@@ -25,6 +49,7 @@ int main(int argc, const char *argv[])
     return 1;
   }
 
+  // the input of a replay is the directory of the captured queries
   if (cmdline.args.size() != 1)
   {
     std::cerr << "Usage error\n";
@@ -33,7 +58,22 @@ int main(int argc, const char *argv[])
 
   try
   {
-    if (has_suffix(cmdline.args.back(), ".sl"))
+    if (cmdline.isset("query-cache"))
+    {
+      // the bound is given in megabytes
+      const std::size_t max_size =
+          cmdline.isset("query-cache-size")
+              ? std::stoul(cmdline.get_value("query-cache-size"))
+              : 1024;
+      query_cache().enable(cmdline.get_value("query-cache"), max_size << 20);
+    }
+
+    if (cmdline.isset("capture-queries"))
+      query_capture().enable(cmdline.get_value("capture-queries"));
+
+    if (cmdline.isset("replay-queries"))
+      return replay_frontend(cmdline);
+    else if (has_suffix(cmdline.args.back(), ".sl"))
       return sygus_frontend(cmdline);
     else if (has_suffix(cmdline.args.back(), ".smt2"))
       return smt2_frontend(cmdline);
@@ -48,4 +88,12 @@ int main(int argc, const char *argv[])
   {
     std::cerr << "Error: " << s << '\n';
   }
+  catch (const std::invalid_argument &)
+  {
+    std::cerr << "Error: invalid number in an option\n";
+  }
+  catch (const std::out_of_range &)
+  {
+    std::cerr << "Error: number out of range in an option\n";
+  }
 }
@@ -1,6 +1,7 @@
 #include "incremental_solver_learn.h"
 
-#include <solvers/flattening/bv_pointers.h>
+#include "sat_solver.h"
+#include "synth_bv.h"
 
 #include <util/prefix.h>
 
@@ -8,13 +9,16 @@ incremental_solver_learnt::incremental_solver_learnt(
   const namespacet &_ns,
   const problemt &_problem,
   bool _use_simp_solver,
-  message_handlert &_message_handler)
+  message_handlert &_message_handler,
+  const std::string &_sat_solver)
   : solver_learn_baset(_ns, _problem, _message_handler),
-    synth_satcheck(new satcheck_no_simplifiert(_message_handler)),
-    synth_solver(new bv_pointerst(ns, *synth_satcheck, _message_handler)),
+    synth_satcheck(new_sat_solver(_sat_solver, false, _message_handler)),
+    synth_solver(new_flattening(
+      ns, *synth_satcheck, _message_handler, has_pointer_type(_problem))),
     program_size(1u),
     counterexample_counter(0u),
-    use_simp_solver(_use_simp_solver)
+    use_simp_solver(_use_simp_solver),
+    sat_solver(_sat_solver)
 {
   init();
 }
@@ -23,13 +27,15 @@ void incremental_solver_learnt::init()
 {
   if(use_simp_solver)
   {
-    synth_satcheck.reset(new satcheckt(get_message_handler()));
-    synth_solver.reset(
-      new bv_pointerst(ns, *synth_satcheck, get_message_handler()));
+    synth_satcheck = new_sat_solver(sat_solver, true, get_message_handler());
+    synth_solver = new_flattening(
+      ns, *synth_satcheck, get_message_handler(), has_pointer_type(problem));
   }
 
   synth_encoding.program_size = program_size;
   synth_encoding.enable_bitwise = enable_bitwise;
+  synth_encoding.operator_budget = operator_budget;
+  synth_encoding.growable = true;
 
   add_problem(synth_encoding, *synth_solver);
   freeze_expression_symbols();
@@ -42,8 +48,21 @@ void incremental_solver_learnt::set_program_size(const size_t program_size)
     return;
   this->program_size = program_size;
 
-  synth_satcheck.reset(new satcheck_minisat_no_simplifiert(get_message_handler()));
-  synth_solver.reset(new bv_pointerst(ns, *synth_satcheck, get_message_handler()));
+  // encode the new instructions only
+  synth_encoding.constraints.clear();
+
+  if(synth_encoding.grow(program_size))
+  {
+    for(const auto &c : synth_encoding.constraints)
+      synth_solver->set_to_true(c);
+
+    freeze_expression_symbols();
+    return;
+  }
+
+  synth_satcheck = new_sat_solver(sat_solver, false, get_message_handler());
+  synth_solver = new_flattening(
+    ns, *synth_satcheck, get_message_handler(), has_pointer_type(problem));
   synth_encoding = synth_encodingt();
   synth_encoding.literals = problem.literals;
 
@@ -69,6 +88,15 @@ void incremental_solver_learnt::set_program_size(const size_t program_size)
 
 decision_proceduret::resultt incremental_solver_learnt::operator()()
 {
+  // the outputs follow the last instruction of the current size
+  const literalt size_literal =
+    synth_solver->convert(program_size_selector(program_size));
+
+  if(use_simp_solver)
+    synth_solver->set_frozen(size_literal);
+
+  synth_solver->set_assumptions({size_literal});
+
   return (*synth_solver)();
 }
 
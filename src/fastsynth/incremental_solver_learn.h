@@ -6,7 +6,7 @@
 #include <fastsynth/synth_encoding.h>
 
 #include <solvers/sat/satcheck.h>
-#include <solvers/flattening/bv_pointers.h>
+#include <solvers/flattening/boolbv.h>
 
 #include <memory>
 
@@ -20,7 +20,7 @@ class incremental_solver_learnt:public solver_learn_baset
   std::unique_ptr<propt> synth_satcheck;
 
   /// Decision procedure for synthesis logic.
-  std::unique_ptr<class bv_pointerst> synth_solver;
+  std::unique_ptr<boolbvt> synth_solver;
 
   /// Synthesis learn constraint generator.
   synth_encodingt synth_encoding;
@@ -37,6 +37,9 @@ class incremental_solver_learnt:public solver_learn_baset
   /// Boolean indicates whether to use simplifying solver
   bool use_simp_solver;
 
+  /// SAT back end, see new_sat_solver().
+  std::string sat_solver;
+
   /// Initialises message handler and adds the base synthesis problem to the
   /// constraint.
   void init();
@@ -51,7 +54,8 @@ public:
     const namespacet &,
     const problemt &,
     bool use_simp_solver,
-    message_handlert &);
+    message_handlert &,
+    const std::string &sat_solver = "");
 
   /// \see learnt::set_program_size(size_t)
   void set_program_size(size_t program_size) override;
@@ -17,7 +17,9 @@ public:
 
   explicit learnt(message_handlert &_message_handler):
     messaget(_message_handler),
-    enable_bitwise(false)
+    enable_bitwise(false),
+    operator_budget(1),
+    distinct_integer_constants(false)
   {
   }
 
@@ -39,6 +41,14 @@ public:
   virtual void add_ce(const counterexamplet &) = 0;
 
   bool enable_bitwise;
+
+  /// Operators with a higher operator_cost() are not used.
+  std::size_t operator_budget;
+
+  /// Whether each instruction on integers gets a constant of its own,
+  /// rather than all sharing one; used when the constants are solved
+  /// by a theory query.
+  bool distinct_integer_constants;
 };
 
 #endif /* CPROVER_FASTSYNTH_LEARN_H_ */
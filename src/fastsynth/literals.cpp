@@ -1,18 +1,32 @@
 #include <fastsynth/literals.h>
 #include <fastsynth/cegis_types.h>
 
+#include <util/arith_tools.h>
 #include <util/expr_iterator.h>
+#include <util/std_types.h>
 
-/// Finds constant literals in an expression container.
+#include <algorithm>
+
+/// Occurrences of a literal in the problem.
+struct literal_statst
+{
+  std::size_t count = 0;
+  std::size_t first = 0;
+};
+
+/// Counts the constant literals in an expression container.
 /// \tparam containert Expression container type.
-/// \param result Container into which to insert found literals.
+/// \param result Map into which to insert found literals.
+/// \param position Number of literal occurrences seen so far.
 /// \param expressions Expressions in which to search for constants.
 template <class containert>
-static void
-find_literals(std::set<constant_exprt> &result, const containert &expressions)
+static void find_literals(
+  std::map<constant_exprt, literal_statst> &result,
+  std::size_t &position,
+  const containert &expressions)
 {
   for (const exprt &e : expressions)
-    for (auto it(e.unique_depth_cbegin()); it != e.unique_depth_cend(); ++it)
+    for (auto it(e.depth_cbegin()); it != e.depth_cend(); ++it)
     {
 
       const constant_exprt *const c =
@@ -21,23 +35,105 @@ find_literals(std::set<constant_exprt> &result, const containert &expressions)
         continue;
       const irep_idt &id = c->type().id();
       if (ID_signedbv == id || ID_unsignedbv == id || ID_integer == id)
-        result.insert(*c);
+      {
+        auto &stats = result[*c];
+        if (stats.count++ == 0)
+          stats.first = position;
+        position++;
+      }
     }
 }
 
-/// Collects all constant literals explicitly used in the problem description.
-/// \param problem Problem in which to search for literals.
-/// \return All constant literals located in the given problem.
-static std::set<constant_exprt> find_literals(const problemt &problem)
+/// Brings a value into the range of a type.
+/// \param value Value to wrap around.
+/// \param type Signed, unsigned bit-vector or integer type.
+/// \return Value of the type that agrees with \p value modulo 2^width.
+static mp_integer wrap(const mp_integer &value, const typet &type)
+{
+  if (type.id() == ID_integer)
+    return value;
+
+  const mp_integer modulus = power(2, to_bitvector_type(type).get_width());
+  mp_integer result = value % modulus;
+
+  if (result.is_negative())
+    result += modulus;
+
+  if (type.id() == ID_signedbv && result >= modulus / 2)
+    result -= modulus;
+
+  return result;
+}
+
+/// Values derived from a literal that are commonly needed along with it.
+/// \param literal Signed, unsigned bit-vector or integer constant.
+/// \return Derived constants of the same type.
+static std::vector<constant_exprt> derived_literals(
+  const constant_exprt &literal)
+{
+  const typet &type = literal.type();
+  const mp_integer value = numeric_cast_v<mp_integer>(literal);
+
+  std::vector<mp_integer> values = {value + 1, value - 1, -value};
+
+  if (type.id() != ID_integer)
+  {
+    values.push_back(-value - 1); // bitwise complement
+
+    // the smallest all-ones mask covering the value
+    const mp_integer unsigned_value =
+      wrap(value, unsignedbv_typet(to_bitvector_type(type).get_width()));
+    values.push_back(power(2, address_bits(unsigned_value + 1)) - 1);
+  }
+
+  std::vector<constant_exprt> result;
+
+  for (const auto &v : values)
+    result.push_back(from_integer(wrap(v, type), type));
+
+  return result;
+}
+
+std::vector<constant_exprt> rank_literals(const problemt &problem)
 {
-  std::set<constant_exprt> result;
-  find_literals(result, problem.constraints);
-  find_literals(result, problem.free_variables);
-  find_literals(result, problem.side_conditions);
+  std::map<constant_exprt, literal_statst> stats;
+  std::size_t position = 0;
+  find_literals(stats, position, problem.side_conditions);
+  find_literals(stats, position, problem.constraints);
+
+  std::vector<constant_exprt> found;
+  for (const auto &s : stats)
+    found.push_back(s.first);
+
+  std::stable_sort(
+    found.begin(),
+    found.end(),
+    [&stats](const constant_exprt &a, const constant_exprt &b) {
+      const auto &sa = stats.at(a);
+      const auto &sb = stats.at(b);
+      return sa.count != sb.count ? sa.count > sb.count : sa.first < sb.first;
+    });
+
+  std::vector<constant_exprt> result = found;
+  std::set<constant_exprt> seen(found.begin(), found.end());
+
+  for (const auto &literal : found)
+    for (const auto &derived : derived_literals(literal))
+      if (seen.insert(derived).second)
+        result.push_back(derived);
+
   return result;
 }
 
-void add_literals(problemt &problem)
+void add_literals(problemt &problem, std::size_t max_literals, bool lazy)
 {
-  problem.literals = find_literals(problem);
+  std::vector<constant_exprt> ranked = rank_literals(problem);
+
+  if (ranked.size() > max_literals)
+    ranked.resize(max_literals);
+
+  if (lazy)
+    problem.lazy_literals = ranked;
+  else
+    problem.literals.insert(ranked.begin(), ranked.end());
 }
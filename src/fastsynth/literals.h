@@ -1,8 +1,27 @@
 #ifndef CPROVER_FASTSYNTH_LITERALS_H_
 #define CPROVER_FASTSYNTH_LITERALS_H_
 
+#include <cstddef>
+#include <vector>
+
+class constant_exprt;
+
+/// Ranks the literals of a problem: literals that occur more often come
+/// first, ties are broken by first occurrence. Values derived from the
+/// literals (plus and minus one, negation, complement and the enclosing
+/// bit mask) follow.
+/// \param problem Problem in which to search literals.
+/// \return Distinct literals, best first.
+std::vector<constant_exprt> rank_literals(const class problemt &problem);
+
 /// Extends a problem by helper literals.
 /// \param problem Problem to extend and in which to search literals.
-void add_literals(class problemt &problem);
+/// \param max_literals Number of ranked literals to use.
+/// \param lazy If true, the literals are put into problemt::lazy_literals
+///   rather than problemt::literals.
+void add_literals(
+  class problemt &problem,
+  std::size_t max_literals = 8,
+  bool lazy = false);
 
 #endif /* CPROVER_FASTSYNTH_LITERALS_H_ */
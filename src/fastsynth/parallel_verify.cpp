@@ -0,0 +1,318 @@
+#include "parallel_verify.h"
+#include "solver.h"
+#include "synth_bv.h"
+
+#include <util/irep_serialization.h>
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+std::vector<parallel_verifyt::clustert> parallel_verifyt::clusters() const
+{
+  const auto &constraints = problem.constraints;
+
+  // union-find over the constraints
+  std::vector<std::size_t> parent(constraints.size());
+  std::iota(parent.begin(), parent.end(), 0);
+
+  const auto find = [&parent](std::size_t i) {
+    while (parent[i] != i)
+      i = parent[i] = parent[parent[i]];
+    return i;
+  };
+
+  // the first constraint each free variable occurs in
+  std::map<exprt, std::size_t> owner;
+
+  for (std::size_t i = 0; i < constraints.size(); i++)
+    for (auto it(constraints[i].unique_depth_cbegin());
+         it != constraints[i].unique_depth_cend();
+         ++it)
+    {
+      if (problem.free_variables.find(*it) == problem.free_variables.end())
+        continue;
+
+      const auto res = owner.emplace(*it, i);
+      if (!res.second)
+        parent[find(i)] = find(res.first->second);
+    }
+
+  std::vector<clustert> result;
+  std::map<std::size_t, std::size_t> cluster_numbers;
+
+  for (std::size_t i = 0; i < constraints.size(); i++)
+  {
+    const auto res = cluster_numbers.emplace(find(i), result.size());
+    if (res.second)
+      result.emplace_back();
+
+    result[res.first->second].push_back(constraints[i]);
+  }
+
+  return result;
+}
+
+decision_proceduret::resultt parallel_verifyt::check(
+    const solutiont &solution,
+    const clustert &cluster)
+{
+  solvert solver_container(
+      use_smt,
+      logic,
+      ns,
+      get_message_handler(),
+      has_pointer_type(problem),
+      sat_solver);
+  auto &solver = solver_container.get();
+
+  verify_encodingt verify_encoding;
+  verify_encoding.functions = solution.functions;
+  verify_encoding.free_variables = problem.free_variables;
+
+  add_problem(verify_encoding, solver, cluster);
+  const decision_proceduret::resultt result = solver();
+
+  if (result == decision_proceduret::resultt::D_SATISFIABLE)
+    counterexample = verify_encoding.get_counterexample(solver);
+  else
+    counterexample.clear();
+
+  return result;
+}
+
+void parallel_verifyt::run_job(
+    const solutiont &solution,
+    const std::vector<clustert> &clusters,
+    const std::vector<std::size_t> &group,
+    int fd)
+{
+  // the output of the parent is not ours to write to
+  null_message_handlert null_message_handler;
+  set_message_handler(null_message_handler);
+
+  char verdict = 'U';
+
+  for (const auto c : group)
+  {
+    const decision_proceduret::resultt result = check(solution, clusters[c]);
+
+    if (result == decision_proceduret::resultt::D_SATISFIABLE)
+    {
+      verdict = 'S';
+      break;
+    }
+    else if (result == decision_proceduret::resultt::D_ERROR)
+    {
+      verdict = 'E';
+      break;
+    }
+  }
+
+  std::ostringstream out;
+  out << verdict;
+
+  if (verdict == 'S')
+  {
+    irep_serializationt::ireps_containert ireps_container;
+    irep_serializationt serialization(ireps_container);
+
+    // the child has a copy of the parent's problem, in the same order
+    for (const auto &v : problem.free_variables)
+      serialization.reference_convert(counterexample.assignment[v], out);
+  }
+
+  const std::string data = out.str();
+
+  for (std::size_t written = 0; written < data.size();)
+  {
+    const ssize_t n = write(fd, data.data() + written, data.size() - written);
+    if (n <= 0)
+      break;
+    written += n;
+  }
+
+  close(fd);
+}
+
+decision_proceduret::resultt parallel_verifyt::read_job(
+    const std::string &data)
+{
+  counterexample.clear();
+
+  if (data.empty() || data[0] == 'E')
+    return decision_proceduret::resultt::D_ERROR;
+
+  if (data[0] == 'U')
+    return decision_proceduret::resultt::D_UNSATISFIABLE;
+
+  std::istringstream in(data.substr(1));
+  irep_serializationt::ireps_containert ireps_container;
+  irep_serializationt serialization(ireps_container);
+
+  for (const auto &v : problem.free_variables)
+    counterexample.assignment[v] =
+        static_cast<const exprt &>(serialization.reference_convert(in));
+
+  return decision_proceduret::resultt::D_SATISFIABLE;
+}
+
+decision_proceduret::resultt parallel_verifyt::operator()(
+    const solutiont &solution)
+{
+  const std::vector<clustert> clusters = this->clusters();
+
+  const std::size_t jobs = std::min<std::size_t>(
+      clusters.size(),
+      max_jobs != 0 ? max_jobs
+                    : std::max(1u, std::thread::hardware_concurrency()));
+
+  if (jobs <= 1)
+    return verifyt::operator()(solution);
+
+  debug() << green << "Candidate: ";
+  output(solution.functions, debug());
+  debug() << reset << eom;
+
+  verify_encodingt::check_function_bodies(solution.functions);
+
+  // clusters are dealt out to the jobs round-robin
+  std::vector<std::vector<std::size_t>> groups(jobs);
+  for (std::size_t c = 0; c < clusters.size(); c++)
+    groups[c % jobs].push_back(c);
+
+  // buffered output would otherwise be written by the children, too
+  std::cout.flush();
+  std::cerr.flush();
+
+  struct jobt
+  {
+    pid_t pid;
+    int fd;
+    std::string data;
+  };
+
+  std::vector<jobt> running;
+
+  for (const auto &group : groups)
+  {
+    int fds[2];
+    if (pipe(fds) != 0)
+      break;
+
+    const pid_t pid = fork();
+
+    if (pid == 0)
+    {
+      close(fds[0]);
+
+      // the parent reports the failure and verifies sequentially
+      try
+      {
+        run_job(solution, clusters, group, fds[1]);
+      }
+      catch (...)
+      {
+        _exit(1);
+      }
+
+      _exit(0);
+    }
+
+    close(fds[1]);
+
+    if (pid < 0)
+    {
+      close(fds[0]);
+      break;
+    }
+
+    running.push_back(jobt{pid, fds[0], std::string()});
+  }
+
+  bool complete = running.size() == groups.size();
+  bool failed = false;
+
+  while (!running.empty() && !failed)
+  {
+    std::vector<pollfd> fds;
+    for (const auto &job : running)
+      fds.push_back(pollfd{job.fd, POLLIN, 0});
+
+    if (poll(fds.data(), fds.size(), -1) < 0)
+    {
+      complete = false;
+      break;
+    }
+
+    for (std::size_t i = 0; i < fds.size() && !failed; i++)
+    {
+      if (fds[i].revents == 0)
+        continue;
+
+      auto &job = running[i];
+      char buffer[4096];
+      const ssize_t n = read(job.fd, buffer, sizeof(buffer));
+
+      if (n > 0)
+      {
+        job.data.append(buffer, n);
+        continue;
+      }
+
+      // the job is done
+      int status;
+      close(job.fd);
+      waitpid(job.pid, &status, 0);
+      job.fd = -1;
+
+      const decision_proceduret::resultt result =
+          WIFEXITED(status) && WEXITSTATUS(status) == 0
+              ? read_job(job.data)
+              : decision_proceduret::resultt::D_ERROR;
+
+      if (result == decision_proceduret::resultt::D_SATISFIABLE)
+        failed = true;
+      else if (result == decision_proceduret::resultt::D_ERROR)
+        complete = false;
+    }
+
+    running.erase(
+        std::remove_if(
+            running.begin(),
+            running.end(),
+            [](const jobt &job) { return job.fd == -1; }),
+        running.end());
+  }
+
+  // a counterexample was found, the other jobs are not needed
+  for (const auto &job : running)
+  {
+    kill(job.pid, SIGKILL);
+    close(job.fd);
+    waitpid(job.pid, nullptr, 0);
+  }
+
+  debug() << "parallel verification of " << clusters.size()
+          << " clusters in " << jobs << " processes" << eom;
+
+  if (failed)
+    return decision_proceduret::resultt::D_SATISFIABLE;
+
+  if (!complete)
+  {
+    warning() << "parallel verification failed, verifying sequentially"
+              << eom;
+    return verifyt::operator()(solution);
+  }
+
+  counterexample.clear();
+  return decision_proceduret::resultt::D_UNSATISFIABLE;
+}
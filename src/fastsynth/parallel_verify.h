@@ -0,0 +1,54 @@
+#ifndef CPROVER_FASTSYNTH_PARALLEL_VERIFY_H_
+#define CPROVER_FASTSYNTH_PARALLEL_VERIFY_H_
+
+#include "verify.h"
+
+/// Verifies a candidate by a separate query for each cluster of
+/// constraints, where constraints that share a free variable are in the
+/// same cluster. Each query has all side conditions, so that its
+/// counterexample is one of the whole problem. The queries run in
+/// parallel in child processes, as the expression and solver libraries
+/// are not thread-safe; the first counterexample wins and the remaining
+/// processes are killed.
+/// Falls back to verifyt if there is only one cluster.
+class parallel_verifyt:public verifyt
+{
+public:
+  parallel_verifyt(
+    const namespacet &_ns,
+    const problemt &_problem,
+    message_handlert &_message_handler):
+    verifyt(_ns, _problem, _message_handler),
+    max_jobs(0)
+  {
+  }
+
+  /// \see verifyt::operator()(const solutiont &)
+  decision_proceduret::resultt operator()(const solutiont &) override;
+
+  /// Number of processes to use; 0 for one per hardware thread.
+  std::size_t max_jobs;
+
+protected:
+  using clustert = exprt::operandst;
+
+  /// Groups the constraints by shared free variables.
+  std::vector<clustert> clusters() const;
+
+  /// Checks the candidate against the constraints of one cluster.
+  decision_proceduret::resultt check(const solutiont &, const clustert &);
+
+  /// Run in a child process: checks the given clusters in turn, until
+  /// one fails, and writes the verdict and counterexample to \p fd.
+  void run_job(
+    const solutiont &,
+    const std::vector<clustert> &,
+    const std::vector<std::size_t> &group,
+    int fd);
+
+  /// Reads the output of run_job into counterexample.
+  /// \return The verdict.
+  decision_proceduret::resultt read_job(const std::string &);
+};
+
+#endif /* CPROVER_FASTSYNTH_PARALLEL_VERIFY_H_ */
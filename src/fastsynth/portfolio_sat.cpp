@@ -0,0 +1,269 @@
+#include "portfolio_sat.h"
+#include "query_capture.h"
+#include "sat_solver.h"
+
+#include <util/message.h>
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+void portfolio_satt::run_copy(std::size_t seed, int fd) const
+{
+  // the output of the parent is not ours to write to
+  null_message_handlert null_message_handler;
+  const auto solver = new_sat_solver(sat_solver, true, null_message_handler);
+
+  const std::size_t variables = no_variables();
+
+  // variable 0 is not used
+  std::vector<literalt> renaming(variables);
+  for (std::size_t v = 0; v < variables; v++)
+    renaming[v] = literalt(v, false);
+
+  std::vector<bvt> copy(clauses.begin(), clauses.end());
+
+  if (seed != 0 && variables > 1)
+  {
+    std::mt19937 random(seed);
+
+    std::vector<literalt::var_not> order(variables - 1);
+    std::iota(order.begin(), order.end(), 1);
+    std::shuffle(order.begin(), order.end(), random);
+
+    for (std::size_t v = 1; v < variables; v++)
+      renaming[v] = literalt(order[v - 1], random() % 2 == 1);
+
+    for (auto &clause : copy)
+      for (auto &l : clause)
+        if (!l.is_constant())
+          l = renaming[l.var_no()].cond_negation(l.sign());
+
+    std::shuffle(copy.begin(), copy.end(), random);
+  }
+
+  solver->set_no_variables(variables);
+
+  for (const auto &clause : copy)
+    solver->lcnf(clause);
+
+  if (seed == 0)
+  {
+    for (const auto &l : phases)
+      ::set_phase(*solver, l);
+  }
+  else
+  {
+    // drawn apart from the renaming, so that the phases of a variable
+    // do not follow its sign
+    std::mt19937 random(seed ^ 0x9e3779b9u);
+
+    for (std::size_t v = 1; v < variables; v++)
+      ::set_phase(*solver, literalt(v, random() % 2 == 1));
+  }
+
+  std::string data;
+
+  switch (solver->prop_solve())
+  {
+  case resultt::P_SATISFIABLE:
+    data = "S";
+    for (std::size_t v = 1; v < variables; v++)
+    {
+      const tvt value = solver->l_get(renaming[v]);
+      data += value.is_true() ? '1' : value.is_false() ? '0' : '?';
+    }
+    break;
+
+  case resultt::P_UNSATISFIABLE:
+    data = "U";
+    break;
+
+  case resultt::P_ERROR:
+    data = "E";
+    break;
+  }
+
+  for (std::size_t written = 0; written < data.size();)
+  {
+    const ssize_t n = write(fd, data.data() + written, data.size() - written);
+    if (n <= 0)
+      break;
+    written += n;
+  }
+
+  close(fd);
+}
+
+propt::resultt portfolio_satt::read_copy(const std::string &data)
+{
+  if (data == "U")
+    return resultt::P_UNSATISFIABLE;
+
+  if (data.empty() || data[0] != 'S' || data.size() != no_variables())
+    return resultt::P_ERROR;
+
+  assignment.resize(no_variables());
+  assignment[0] = tvt::unknown();
+
+  for (std::size_t v = 1; v < data.size(); v++)
+    assignment[v] =
+        data[v] == '?' ? tvt::unknown() : tvt(data[v] == '1');
+
+  return resultt::P_SATISFIABLE;
+}
+
+bool portfolio_satt::set_phase(literalt literal)
+{
+  if (phases_supported)
+    phases.push_back(literal);
+
+  return phases_supported;
+}
+
+propt::resultt portfolio_satt::prop_solve()
+{
+  // buffered output would otherwise be written by the children, too
+  std::cout.flush();
+  std::cerr.flush();
+
+  struct copyt
+  {
+    std::size_t seed;
+    pid_t pid;
+    int fd;
+    std::string data;
+  };
+
+  std::vector<copyt> running;
+
+  for (std::size_t seed = 0; seed < copies; seed++)
+  {
+    int fds[2];
+    if (pipe(fds) != 0)
+      break;
+
+    const pid_t pid = fork();
+
+    if (pid == 0)
+    {
+      close(fds[0]);
+
+      // a copy that fails does not answer
+      try
+      {
+        run_copy(seed, fds[1]);
+      }
+      catch (...)
+      {
+        _exit(1);
+      }
+
+      _exit(0);
+    }
+
+    close(fds[1]);
+
+    if (pid < 0)
+    {
+      close(fds[0]);
+      break;
+    }
+
+    running.push_back(copyt{seed, pid, fds[0], std::string()});
+  }
+
+  resultt result = resultt::P_ERROR;
+  bool answered = false;
+
+  while (!running.empty() && !answered)
+  {
+    std::vector<pollfd> fds;
+    for (const auto &copy : running)
+      fds.push_back(pollfd{copy.fd, POLLIN, 0});
+
+    if (poll(fds.data(), fds.size(), -1) < 0)
+      break;
+
+    for (std::size_t i = 0; i < fds.size() && !answered; i++)
+    {
+      if (fds[i].revents == 0)
+        continue;
+
+      auto &copy = running[i];
+      char buffer[4096];
+      const ssize_t n = read(copy.fd, buffer, sizeof(buffer));
+
+      if (n > 0)
+      {
+        copy.data.append(buffer, n);
+        continue;
+      }
+
+      // the copy is done
+      int status;
+      close(copy.fd);
+      waitpid(copy.pid, &status, 0);
+      copy.fd = -1;
+
+      if (!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        continue;
+
+      result = read_copy(copy.data);
+
+      if (result != resultt::P_ERROR)
+      {
+        answered = true;
+        winner = copy.seed;
+      }
+    }
+
+    running.erase(
+        std::remove_if(
+            running.begin(),
+            running.end(),
+            [](const copyt &copy) { return copy.fd == -1; }),
+        running.end());
+  }
+
+  // the first answer wins
+  for (const auto &copy : running)
+  {
+    kill(copy.pid, SIGKILL);
+    close(copy.fd);
+    waitpid(copy.pid, nullptr, 0);
+  }
+
+  return result;
+}
+
+std::unique_ptr<propt> new_sat_portfolio(
+  const std::string &sat_solver,
+  std::size_t copies,
+  message_handlert &message_handler)
+{
+  // an unknown back end is reported here rather than in the children
+  auto solver = new_sat_solver(sat_solver, true, message_handler);
+
+  if (copies > 1)
+  {
+    // the copies are made by the same back end
+    solver->set_no_variables(2);
+    const bool phases_supported = set_phase(*solver, literalt(1, false));
+
+    solver = std::unique_ptr<propt>(new portfolio_satt(
+        copies, sat_solver, phases_supported, message_handler));
+  }
+
+  if (query_capture().enabled())
+    solver = std::unique_ptr<propt>(
+        new capture_propt(std::move(solver), message_handler));
+
+  return solver;
+}
@@ -0,0 +1,75 @@
+#ifndef CPROVER_FASTSYNTH_PORTFOLIO_SAT_H_
+#define CPROVER_FASTSYNTH_PORTFOLIO_SAT_H_
+
+#include "sat_solver.h"
+
+#include <solvers/sat/cnf_clause_list.h>
+
+#include <memory>
+
+/// Collects the clauses of a query and solves copies of it in parallel
+/// child processes, taking the answer of the first copy to finish.
+/// Copy 0 is the query as given; copy i renames the variables by a
+/// permutation drawn with seed i, negates about half of them and
+/// shuffles the clauses, which gives any back end a different
+/// branching order and course of restarts. Copy i also draws an
+/// initial phase for each variable, on back ends that support
+/// set_phase(); copy 0 is given the phases set on the portfolio.
+/// The copies do not share learnt clauses.
+class portfolio_satt:public cnf_clause_list_assignmentt, public phase_hookt
+{
+public:
+  /// \param copies Number of copies to run.
+  /// \param sat_solver Back end of each copy, see new_sat_solver().
+  /// \param phases_supported Whether the back end supports set_phase().
+  portfolio_satt(
+    std::size_t _copies,
+    const std::string &_sat_solver,
+    bool _phases_supported,
+    message_handlert &_message_handler):
+    cnf_clause_list_assignmentt(_message_handler),
+    copies(_copies),
+    sat_solver(_sat_solver),
+    winner(0),
+    phases_supported(_phases_supported)
+  {
+  }
+
+  resultt prop_solve() override;
+
+  bool set_phase(literalt) override;
+
+  const std::string solver_text() override
+  {
+    return "portfolio of " + std::to_string(copies);
+  }
+
+  std::size_t copies;
+  std::string sat_solver;
+
+  /// The copy that answered the last query.
+  std::size_t winner;
+
+protected:
+  bool phases_supported;
+
+  /// The phases set on the portfolio, in the order they were set.
+  bvt phases;
+
+  /// Run in a child process: solves copy \p seed and writes the result
+  /// and the assignment of the original variables to \p fd.
+  void run_copy(std::size_t seed, int fd) const;
+
+  /// Reads the output of run_copy into the assignment.
+  resultt read_copy(const std::string &);
+};
+
+/// new_sat_solver(), or a portfolio_satt if \p copies is above 1.
+/// The back end is wrapped into a capture_propt if query_capture() is
+/// enabled.
+std::unique_ptr<propt> new_sat_portfolio(
+  const std::string &sat_solver,
+  std::size_t copies,
+  message_handlert &);
+
+#endif /* CPROVER_FASTSYNTH_PORTFOLIO_SAT_H_ */
@@ -0,0 +1,206 @@
+#include "query_cache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+/// Suffix of the entries in the cache directory.
+static const std::string entry_suffix = ".response";
+
+void query_hasht::add_char(unsigned char c)
+{
+  value = (value ^ c) * 1099511628211ull;
+  digest_value = (digest_value + c + 1) * 11400714819323198485ull;
+  length++;
+}
+
+void query_hasht::add(const std::string &text)
+{
+  for (const char c : text)
+  {
+    if (quote != 0)
+    {
+      // a doubled quote in a string literal closes and reopens it
+      if (c == quote)
+        quote = 0;
+    }
+    else if (c == '|' || c == '"')
+      quote = c;
+    else if (std::isspace(static_cast<unsigned char>(c)))
+    {
+      if (space)
+        continue;
+
+      space = true;
+      add_char(' ');
+      continue;
+    }
+
+    space = false;
+    add_char(static_cast<unsigned char>(c));
+  }
+}
+
+std::string query_hasht::key() const
+{
+  std::ostringstream result;
+  result << std::hex << value << '-' << std::dec << length;
+  return result.str();
+}
+
+std::string query_hasht::digest() const
+{
+  std::ostringstream result;
+  result << std::hex << digest_value;
+  return result.str();
+}
+
+void query_cachet::enable(const std::string &_directory, std::size_t _max_size)
+{
+  directory = _directory;
+  max_size = _max_size;
+  mkdir(directory.c_str(), 0777);
+  evict();
+}
+
+std::string query_cachet::path(const query_hasht &hash) const
+{
+  return directory + "/" + hash.key() + entry_suffix;
+}
+
+bool query_cachet::lookup(const query_hasht &hash, std::string &response)
+{
+  if (!enabled())
+    return false;
+
+  const std::string file = path(hash);
+  std::ifstream in(file, std::ios::binary);
+
+  if (!in)
+  {
+    misses++;
+    return false;
+  }
+
+  std::string digest;
+  std::getline(in, digest);
+
+  // another query with the same key
+  if (!in || digest != hash.digest())
+  {
+    misses++;
+    return false;
+  }
+
+  std::ostringstream contents;
+  contents << in.rdbuf();
+  response = contents.str();
+  hits++;
+
+  // the modification time orders the entries for eviction
+  utime(file.c_str(), nullptr);
+
+  return true;
+}
+
+void query_cachet::store(const query_hasht &hash, const std::string &response)
+{
+  if (!enabled())
+    return;
+
+  // concurrent runs only ever see complete entries
+  const std::string file = path(hash);
+  const std::string temporary = file + "." + std::to_string(getpid());
+
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out << hash.digest() << '\n' << response;
+
+    if (!out)
+    {
+      unlink(temporary.c_str());
+      return;
+    }
+  }
+
+  if (rename(temporary.c_str(), file.c_str()) != 0)
+  {
+    unlink(temporary.c_str());
+    return;
+  }
+
+  // other runs sharing the directory are noticed at the next scan
+  size += response.size();
+
+  if (size > max_size)
+    evict();
+}
+
+void query_cachet::evict()
+{
+  DIR *dir = opendir(directory.c_str());
+
+  if (dir == nullptr)
+    return;
+
+  // modification time, size and path of each entry
+  std::vector<std::pair<time_t, std::pair<std::size_t, std::string>>> entries;
+  std::size_t total = 0;
+
+  while (const dirent *d = readdir(dir))
+  {
+    const std::string name = d->d_name;
+
+    if (name.size() <= entry_suffix.size() ||
+        name.compare(
+          name.size() - entry_suffix.size(),
+          entry_suffix.size(),
+          entry_suffix) != 0)
+    {
+      continue;
+    }
+
+    const std::string file = directory + "/" + name;
+    struct stat s;
+
+    if (stat(file.c_str(), &s) != 0)
+      continue;
+
+    entries.emplace_back(s.st_mtime, std::make_pair(s.st_size, file));
+    total += s.st_size;
+  }
+
+  closedir(dir);
+
+  size = total;
+
+  if (total <= max_size)
+    return;
+
+  std::sort(entries.begin(), entries.end());
+
+  for (const auto &e : entries)
+  {
+    if (total <= max_size)
+      break;
+
+    if (unlink(e.second.second.c_str()) == 0)
+      total -= e.second.first;
+  }
+
+  size = total;
+}
+
+query_cachet &query_cache()
+{
+  static query_cachet cache;
+  return cache;
+}
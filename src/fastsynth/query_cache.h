@@ -0,0 +1,97 @@
+#ifndef CPROVER_FASTSYNTH_QUERY_CACHE_H_
+#define CPROVER_FASTSYNTH_QUERY_CACHE_H_
+
+#include <cstdint>
+#include <string>
+
+/// FNV-1a hash of a query, computed incrementally over its text with
+/// each run of whitespace outside quoted symbols and string literals
+/// collapsed into a single space. A second, independent hash of the
+/// same text is the digest that cache entries are checked against.
+class query_hasht
+{
+public:
+  query_hasht():
+    value(14695981039346656037ull),
+    digest_value(0),
+    length(0),
+    space(false),
+    quote(0)
+  {
+  }
+
+  void add(const std::string &);
+
+  /// Name of the cache entry for the query.
+  std::string key() const;
+
+  /// Stored in the cache entry, to tell queries with the same key apart.
+  std::string digest() const;
+
+protected:
+  std::uint64_t value;
+  std::uint64_t digest_value;
+
+  /// Number of characters hashed.
+  std::size_t length;
+
+  /// Whether the last character was whitespace.
+  bool space;
+
+  /// The closing character of the quoted symbol or string literal the
+  /// text ends in, or 0.
+  char quote;
+
+  void add_char(unsigned char);
+};
+
+/// Responses of solvers, kept on disk so that reruns skip the queries
+/// they have answered before. The response holds the result and the
+/// model, which the back end reads as if it came from the solver. An
+/// entry starts with the digest of its query, and is only returned for
+/// a query with the same digest.
+/// The queries should name their back end, as responses of different
+/// back ends are not interchangeable. The least recently used entries
+/// are evicted once the entries exceed the size bound.
+class query_cachet
+{
+public:
+  query_cachet():hits(0), misses(0), max_size(0), size(0)
+  {
+  }
+
+  /// Stores the entries in \p directory, which is created if needed.
+  /// \param max_size Bound on the size of all entries, in bytes.
+  void enable(const std::string &directory, std::size_t max_size);
+
+  bool enabled() const
+  {
+    return !directory.empty();
+  }
+
+  /// \return True if the response of the query is known.
+  bool lookup(const query_hasht &, std::string &response);
+
+  void store(const query_hasht &, const std::string &response);
+
+  std::size_t hits, misses;
+
+protected:
+  std::string directory;
+  std::size_t max_size;
+
+  /// Size of the entries as of the last scan, plus the entries stored
+  /// since.
+  std::size_t size;
+
+  std::string path(const query_hasht &) const;
+
+  /// Scans the entries, and removes the least recently used ones while
+  /// they exceed max_size.
+  void evict();
+};
+
+/// The cache shared by all back ends, disabled unless enabled.
+query_cachet &query_cache();
+
+#endif /* CPROVER_FASTSYNTH_QUERY_CACHE_H_ */
@@ -0,0 +1,111 @@
+#include "query_capture.h"
+
+#include <chrono>
+#include <sstream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+void query_capturet::enable(const std::string &_directory)
+{
+  directory = _directory;
+  mkdir(directory.c_str(), 0777);
+
+  // appended to by child processes, too
+  index.open(directory + "/index.tsv", std::ios::out | std::ios::trunc);
+  index.close();
+  index.open(directory + "/index.tsv", std::ios::out | std::ios::app);
+}
+
+void query_capturet::capture(
+  const std::string &role,
+  const std::string &format,
+  const std::string &query,
+  const std::string &result,
+  double seconds)
+{
+  if (!enabled())
+    return;
+
+  const std::string identifier =
+    std::to_string(getpid()) + "-" + std::to_string(count++);
+
+  {
+    std::ofstream out(directory + "/" + capture_file_name(identifier, format));
+    out << query;
+  }
+
+  // flushed, so that child processes do not write the line again
+  index << identifier << '\t' << role << '\t' << iteration << '\t'
+        << program_size << '\t' << format << '\t' << result << '\t'
+        << seconds << std::endl;
+}
+
+query_capturet &query_capture()
+{
+  static query_capturet capture;
+  return capture;
+}
+
+std::string capture_file_name(
+  const std::string &identifier,
+  const std::string &format)
+{
+  return identifier + "." + (format == "sygus" ? "sl" : format);
+}
+
+std::string capture_propt::dimacs() const
+{
+  std::ostringstream out;
+
+  // variable 0 is not used
+  out << "p cnf " << no_variables() - 1 << ' ' << clauses.size() << '\n';
+
+  for (const auto &clause : clauses)
+  {
+    for (const auto &l : clause)
+      out << l.dimacs() << ' ';
+    out << "0\n";
+  }
+
+  return out.str();
+}
+
+bool capture_propt::set_phase(literalt literal)
+{
+  // the back end may not have the variable yet
+  solver->set_no_variables(no_variables());
+  return ::set_phase(*solver, literal);
+}
+
+propt::resultt capture_propt::prop_solve()
+{
+  solver->set_no_variables(no_variables());
+
+  auto it = clauses.begin();
+  std::advance(it, copied);
+
+  for (; it != clauses.end(); ++it)
+    solver->lcnf(*it);
+
+  copied = clauses.size();
+
+  const auto start_time = std::chrono::steady_clock::now();
+  const resultt result = solver->prop_solve();
+  const std::chrono::duration<double> seconds =
+    std::chrono::steady_clock::now() - start_time;
+
+  if (result == resultt::P_SATISFIABLE)
+    copy_assignment_from(*solver);
+
+  query_capture().capture(
+    query_capture().role,
+    "dimacs",
+    dimacs(),
+    result == resultt::P_SATISFIABLE
+      ? "sat"
+      : result == resultt::P_UNSATISFIABLE ? "unsat" : "error",
+    seconds.count());
+
+  return result;
+}
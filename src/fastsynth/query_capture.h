@@ -0,0 +1,97 @@
+#ifndef CPROVER_FASTSYNTH_QUERY_CAPTURE_H_
+#define CPROVER_FASTSYNTH_QUERY_CAPTURE_H_
+
+#include "sat_solver.h"
+
+#include <solvers/sat/cnf_clause_list.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+/// Writes the queries that are sent to solvers into a directory, for
+/// replay_frontend. Each query is in a file named by its identifier and
+/// format, see capture_file_name(); index.tsv has a line per query with
+/// its identifier, role, CEGIS iteration, program size, format, result
+/// and solver time in seconds. Identifiers start with the process id,
+/// as child processes capture their queries, too.
+class query_capturet
+{
+public:
+  query_capturet():iteration(0), program_size(0), count(0)
+  {
+  }
+
+  /// Creates \p directory if needed, and starts a new index in it.
+  void enable(const std::string &directory);
+
+  bool enabled() const
+  {
+    return !directory.empty();
+  }
+
+  /// Context of the queries, set by the CEGIS loop.
+  std::string role;
+  std::size_t iteration;
+  std::size_t program_size;
+
+  /// Writes a query and its line in the index.
+  /// \param format "dimacs", "smt2" or "sygus".
+  /// \param result "sat", "unsat" or "error"; "done" for SyGuS
+  ///   queries, whose result is only known once the response is parsed.
+  void capture(
+    const std::string &role,
+    const std::string &format,
+    const std::string &query,
+    const std::string &result,
+    double seconds);
+
+protected:
+  std::string directory;
+  std::size_t count;
+  std::ofstream index;
+};
+
+/// The capture shared by all back ends, disabled unless enabled.
+query_capturet &query_capture();
+
+/// Name of the file a query of the given format is written to.
+std::string capture_file_name(
+  const std::string &identifier,
+  const std::string &format);
+
+/// Collects the clauses of a query and solves them with another back
+/// end, capturing them in DIMACS format. The back end is given the
+/// clauses added since its last call, and the phases as they are set.
+class capture_propt:public cnf_clause_list_assignmentt, public phase_hookt
+{
+public:
+  capture_propt(
+    std::unique_ptr<propt> _solver,
+    message_handlert &_message_handler):
+    cnf_clause_list_assignmentt(_message_handler),
+    solver(std::move(_solver)),
+    copied(0)
+  {
+  }
+
+  resultt prop_solve() override;
+
+  const std::string solver_text() override
+  {
+    return solver->solver_text();
+  }
+
+  bool set_phase(literalt) override;
+
+protected:
+  std::unique_ptr<propt> solver;
+
+  /// Number of clauses the back end has.
+  std::size_t copied;
+
+  /// The clauses in DIMACS format.
+  std::string dimacs() const;
+};
+
+#endif /* CPROVER_FASTSYNTH_QUERY_CAPTURE_H_ */
@@ -0,0 +1,228 @@
+#include "replay_frontend.h"
+#include "portfolio_sat.h"
+#include "query_capture.h"
+
+#include <util/cout_message.h>
+#include <util/run.h>
+#include <util/tempfile.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+
+/// A line of the index written by query_capturet.
+struct captured_queryt
+{
+  std::string identifier;
+  std::string role;
+  std::string iteration;
+  std::string program_size;
+  std::string format;
+  std::string result;
+  double seconds;
+};
+
+static bool read_index_line(const std::string &line, captured_queryt &query)
+{
+  std::istringstream in(line);
+
+  return static_cast<bool>(
+    std::getline(in, query.identifier, '\t') &&
+    std::getline(in, query.role, '\t') &&
+    std::getline(in, query.iteration, '\t') &&
+    std::getline(in, query.program_size, '\t') &&
+    std::getline(in, query.format, '\t') &&
+    std::getline(in, query.result, '\t') && in >> query.seconds);
+}
+
+/// Solves a query in DIMACS format with a SAT back end.
+static std::string replay_dimacs(
+  const std::string &file,
+  const std::string &sat_solver,
+  std::size_t portfolio,
+  message_handlert &message_handler)
+{
+  std::ifstream in(file);
+  std::string p, cnf;
+  std::size_t variables, clauses;
+
+  if (!(in >> p >> cnf >> variables >> clauses) || p != "p" || cnf != "cnf")
+    return "error";
+
+  const auto solver =
+    new_sat_portfolio(sat_solver, portfolio, message_handler);
+
+  // variable 0 is not used
+  solver->set_no_variables(variables + 1);
+
+  bvt clause;
+  long l;
+
+  while (in >> l)
+  {
+    if (l == 0)
+    {
+      solver->lcnf(clause);
+      clause.clear();
+    }
+    else
+      clause.push_back(
+        literalt(static_cast<literalt::var_not>(std::labs(l)), l < 0));
+  }
+
+  switch (solver->prop_solve())
+  {
+  case propt::resultt::P_SATISFIABLE:
+    return "sat";
+  case propt::resultt::P_UNSATISFIABLE:
+    return "unsat";
+  case propt::resultt::P_ERROR:
+    break;
+  }
+
+  return "error";
+}
+
+/// Runs a solver on a query file.
+/// \return The first line of the output for SMT-LIB2 queries, "done"
+///   for SyGuS queries, or "error" if the solver fails.
+static std::string replay_command(
+  std::vector<std::string> argv,
+  const std::string &file,
+  bool first_line)
+{
+  temporary_filet temp_file_stdout("replay_stdout_", "");
+
+  argv.push_back(file);
+
+  if (run(argv[0], argv, "", temp_file_stdout(), "") != 0)
+    return "error";
+
+  if (!first_line)
+    return "done";
+
+  std::ifstream out(temp_file_stdout());
+  std::string line;
+  std::getline(out, line);
+
+  return line == "sat" || line == "unsat" ? line : "error";
+}
+
+/// Splits a command line at spaces.
+static std::vector<std::string> split_command(const std::string &command)
+{
+  std::vector<std::string> result;
+  std::istringstream in(command);
+  std::string word;
+
+  while (in >> word)
+    result.push_back(word);
+
+  return result;
+}
+
+int replay_frontend(const cmdlinet &cmdline)
+{
+  console_message_handlert message_handler;
+  messaget message(message_handler);
+
+  const std::string directory = cmdline.args.front();
+  std::ifstream index(directory + "/index.tsv");
+
+  if (!index)
+  {
+    message.error() << "Failed to open the index of " << directory
+                    << messaget::eom;
+    return 10;
+  }
+
+  const std::string sat_solver = cmdline.get_value("sat-solver");
+
+  const std::size_t portfolio =
+    cmdline.isset("sat-portfolio")
+      ? std::stoul(cmdline.get_value("sat-portfolio"))
+      : 1;
+
+  const std::vector<std::string> smt_solver = split_command(
+    cmdline.isset("smt-solver") ? cmdline.get_value("smt-solver")
+                                : "z3 -smt2");
+
+  const std::vector<std::string> sygus_solver = {
+    "cvc4", "--lang", "sygus2", "--sygus-active-gen=enum", "--nl-ext-tplanes"};
+
+  const std::string role = cmdline.get_value("replay-role");
+
+  // number of queries, captured and replayed time, by format
+  struct totalt
+  {
+    std::size_t queries = 0;
+    double captured = 0, replayed = 0;
+  };
+
+  std::map<std::string, totalt> totals;
+  std::size_t changed = 0;
+
+  std::string line;
+
+  while (std::getline(index, line))
+  {
+    captured_queryt query;
+
+    if (!read_index_line(line, query))
+      continue;
+
+    if (!role.empty() && query.role != role)
+      continue;
+
+    const std::string file =
+      directory + "/" + capture_file_name(query.identifier, query.format);
+
+    const auto start_time = std::chrono::steady_clock::now();
+    std::string result;
+
+    if (query.format == "dimacs")
+      result = replay_dimacs(file, sat_solver, portfolio, message_handler);
+    else if (query.format == "smt2")
+      result = replay_command(smt_solver, file, true);
+    else if (query.format == "sygus")
+      result = replay_command(sygus_solver, file, false);
+    else
+      continue;
+
+    const std::chrono::duration<double> seconds =
+      std::chrono::steady_clock::now() - start_time;
+
+    std::cout << query.identifier << ' ' << query.role << " iteration "
+              << query.iteration << " size " << query.program_size << ' '
+              << query.format << ": " << query.result << ' ' << std::fixed
+              << std::setprecision(3) << query.seconds << "s -> " << result
+              << ' ' << seconds.count() << "s";
+
+    if (result != query.result)
+    {
+      std::cout << " (changed)";
+      changed++;
+    }
+
+    std::cout << '\n';
+
+    auto &total = totals[query.format];
+    total.queries++;
+    total.captured += query.seconds;
+    total.replayed += seconds.count();
+  }
+
+  for (const auto &t : totals)
+    std::cout << "Total " << t.first << ": " << t.second.queries
+              << " queries, " << t.second.captured << "s captured, "
+              << t.second.replayed << "s replayed\n";
+
+  if (changed != 0)
+    std::cout << changed << " queries with a different result\n";
+
+  return 0;
+}
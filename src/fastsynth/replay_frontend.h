@@ -0,0 +1,3 @@
+#include <util/cmdline.h>
+
+int replay_frontend(const cmdlinet &);
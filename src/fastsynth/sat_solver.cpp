@@ -0,0 +1,253 @@
+#include "sat_solver.h"
+
+#include <solvers/sat/cnf.h>
+#include <solvers/sat/satcheck.h>
+
+#include <util/prefix.h>
+
+#include <dlfcn.h>
+
+/// IPASIR solver from a shared library opened with dlopen.
+class ipasir_dlopent:public cnf_solvert
+{
+public:
+  ipasir_dlopent(const std::string &library, message_handlert &);
+  ~ipasir_dlopent() override;
+
+  const std::string solver_text() override;
+  tvt l_get(literalt) const override;
+  void lcnf(const bvt &) override;
+  resultt prop_solve() override;
+  void set_assignment(literalt, bool) override;
+
+  void set_assumptions(const bvt &_assumptions) override
+  {
+    assumptions = _assumptions;
+  }
+
+  bool has_set_assumptions() const override
+  {
+    return true;
+  }
+
+  bool is_in_conflict(literalt) const override;
+
+  bool has_is_in_conflict() const override
+  {
+    return true;
+  }
+
+protected:
+  void *handle;
+  void *solver;
+  bvt assumptions;
+
+  const char *(*ipasir_signature)();
+  void *(*ipasir_init)();
+  void (*ipasir_release)(void *);
+  void (*ipasir_add)(void *, int);
+  void (*ipasir_assume)(void *, int);
+  int (*ipasir_solve)(void *);
+  int (*ipasir_val)(void *, int);
+  int (*ipasir_failed)(void *, int);
+
+  /// Looks up a function of the library.
+  template <typename functiont>
+  void bind(functiont &function, const char *name)
+  {
+    function = reinterpret_cast<functiont>(dlsym(handle, name));
+
+    if (function == nullptr)
+      throw std::string("IPASIR library lacks ") + name;
+  }
+};
+
+ipasir_dlopent::ipasir_dlopent(
+    const std::string &library,
+    message_handlert &message_handler)
+    : cnf_solvert(message_handler), solver(nullptr)
+{
+  handle = dlopen(library.c_str(), RTLD_NOW | RTLD_LOCAL);
+
+  if (handle == nullptr)
+    throw "cannot load IPASIR library " + library + ": " + dlerror();
+
+  try
+  {
+    bind(ipasir_signature, "ipasir_signature");
+    bind(ipasir_init, "ipasir_init");
+    bind(ipasir_release, "ipasir_release");
+    bind(ipasir_add, "ipasir_add");
+    bind(ipasir_assume, "ipasir_assume");
+    bind(ipasir_solve, "ipasir_solve");
+    bind(ipasir_val, "ipasir_val");
+    bind(ipasir_failed, "ipasir_failed");
+  }
+  catch (...)
+  {
+    dlclose(handle);
+    throw;
+  }
+
+  solver = ipasir_init();
+}
+
+ipasir_dlopent::~ipasir_dlopent()
+{
+  if (solver != nullptr)
+    ipasir_release(solver);
+
+  dlclose(handle);
+}
+
+const std::string ipasir_dlopent::solver_text()
+{
+  return ipasir_signature();
+}
+
+tvt ipasir_dlopent::l_get(literalt a) const
+{
+  if (a.is_constant())
+    return tvt(a.sign());
+
+  if (a.var_no() >= no_variables())
+    return tvt::unknown();
+
+  const int value = ipasir_val(solver, a.dimacs());
+
+  if (value > 0)
+    return tvt(true);
+  else if (value < 0)
+    return tvt(false);
+  else
+    return tvt::unknown();
+}
+
+void ipasir_dlopent::lcnf(const bvt &clause)
+{
+  for (const auto &l : clause)
+    if (l.is_true())
+      return;
+
+  for (const auto &l : clause)
+    if (!l.is_false())
+      ipasir_add(solver, l.dimacs());
+
+  ipasir_add(solver, 0);
+  clause_counter++;
+}
+
+propt::resultt ipasir_dlopent::prop_solve()
+{
+  for (const auto &l : assumptions)
+  {
+    if (l.is_false())
+      return resultt::P_UNSATISFIABLE;
+
+    if (!l.is_true())
+      ipasir_assume(solver, l.dimacs());
+  }
+
+  switch (ipasir_solve(solver))
+  {
+  case 10:
+    status = statust::SAT;
+    return resultt::P_SATISFIABLE;
+
+  case 20:
+    status = statust::UNSAT;
+    return resultt::P_UNSATISFIABLE;
+
+  default:
+    status = statust::ERROR;
+    return resultt::P_ERROR;
+  }
+}
+
+void ipasir_dlopent::set_assignment(literalt, bool)
+{
+  UNREACHABLE;
+}
+
+bool ipasir_dlopent::is_in_conflict(literalt a) const
+{
+  return ipasir_failed(solver, a.dimacs()) != 0;
+}
+
+std::unique_ptr<propt> new_sat_solver(
+    const std::string &name,
+    bool simplifier,
+    message_handlert &message_handler)
+{
+  if (name.empty())
+  {
+    if (simplifier)
+      return std::unique_ptr<propt>(new satcheckt(message_handler));
+    else
+      return std::unique_ptr<propt>(
+          new satcheck_no_simplifiert(message_handler));
+  }
+
+  if (has_prefix(name, "ipasir:"))
+    return std::unique_ptr<propt>(
+        new ipasir_dlopent(name.substr(7), message_handler));
+
+#ifdef HAVE_MINISAT2
+  if (name == "minisat")
+  {
+    if (simplifier)
+      return std::unique_ptr<propt>(
+          new satcheck_minisat_simplifiert(message_handler));
+    else
+      return std::unique_ptr<propt>(
+          new satcheck_minisat_no_simplifiert(message_handler));
+  }
+#endif
+
+#ifdef HAVE_GLUCOSE
+  if (name == "glucose")
+  {
+    if (simplifier)
+      return std::unique_ptr<propt>(
+          new satcheck_glucose_simplifiert(message_handler));
+    else
+      return std::unique_ptr<propt>(
+          new satcheck_glucose_no_simplifiert(message_handler));
+  }
+#endif
+
+#ifdef HAVE_CADICAL
+  if (name == "cadical")
+    return std::unique_ptr<propt>(new satcheck_cadicalt(message_handler));
+#endif
+
+  throw "SAT solver `" + name + "' is not available";
+}
+
+bool set_phase(propt &prop, literalt literal)
+{
+  if (literal.is_constant())
+    return false;
+
+  if (auto hook = dynamic_cast<phase_hookt *>(&prop))
+    return hook->set_phase(literal);
+
+  // the polarity of minisat is the sign of the literal it tries first
+#ifdef HAVE_MINISAT2
+  if (auto satcheck = dynamic_cast<satcheck_minisat_simplifiert *>(&prop))
+  {
+    satcheck->set_polarity(literal, literal.sign());
+    return true;
+  }
+
+  if (auto satcheck = dynamic_cast<satcheck_minisat_no_simplifiert *>(&prop))
+  {
+    satcheck->set_polarity(literal, literal.sign());
+    return true;
+  }
+#else
+  (void)prop;
+#endif
+
+  return false;
+}
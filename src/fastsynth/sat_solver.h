@@ -0,0 +1,39 @@
+#ifndef CPROVER_FASTSYNTH_SAT_SOLVER_H_
+#define CPROVER_FASTSYNTH_SAT_SOLVER_H_
+
+#include <solvers/prop/prop.h>
+
+#include <memory>
+#include <string>
+
+/// Creates a SAT back end by name: "minisat", "glucose" or "cadical"
+/// if built in, or "ipasir:<library>" for a shared library that
+/// implements IPASIR, loaded at run time. The empty name gives the
+/// default back end of the build.
+/// Throws a message if the back end is not available.
+/// \param name Name of the back end.
+/// \param simplifier Whether a preprocessing back end may be used; the
+///   caller must then freeze the literals it uses across calls.
+std::unique_ptr<propt> new_sat_solver(
+  const std::string &name,
+  bool simplifier,
+  message_handlert &);
+
+/// Implemented by back ends that wrap another one, so that set_phase()
+/// reaches the back end that solves.
+class phase_hookt
+{
+public:
+  virtual ~phase_hookt() = default;
+
+  /// \return False if the back end does not support phases.
+  virtual bool set_phase(literalt) = 0;
+};
+
+/// Makes the back end try \p literal true first, if it supports
+/// setting phases. Back ends that implement phase_hookt are given the
+/// literal to forward.
+/// \return False if the back end does not support phases.
+bool set_phase(propt &, literalt);
+
+#endif /* CPROVER_FASTSYNTH_SAT_SOLVER_H_ */
@@ -0,0 +1,269 @@
+#include "smt2_session.h"
+#include "query_capture.h"
+
+#include <chrono>
+#include <sstream>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+/// Printed by the solver after each response.
+static const char response_end[] = "fastsynth-end-of-response";
+
+smt2_processt::smt2_processt()
+    : started(false), pid(-1), to_solver(-1), from_solver(-1), ok(false)
+{
+}
+
+void smt2_processt::start()
+{
+  started = true;
+
+  // a solver that has exited must not kill us through SIGPIPE
+  signal(SIGPIPE, SIG_IGN);
+
+  int input[2], output[2];
+
+  if (pipe(input) != 0)
+    return;
+
+  if (pipe(output) != 0)
+  {
+    close(input[0]);
+    close(input[1]);
+    return;
+  }
+
+  pid = fork();
+
+  if (pid == 0)
+  {
+    dup2(input[0], STDIN_FILENO);
+    dup2(output[1], STDOUT_FILENO);
+    close(input[0]);
+    close(input[1]);
+    close(output[0]);
+    close(output[1]);
+    execlp("z3", "z3", "-in", "-smt2", nullptr);
+    _exit(127);
+  }
+
+  close(input[0]);
+  close(output[1]);
+  to_solver = input[1];
+  from_solver = output[0];
+  ok = pid > 0;
+}
+
+smt2_processt::~smt2_processt()
+{
+  if (ok)
+    send("(exit)\n");
+
+  if (to_solver >= 0)
+    close(to_solver);
+
+  if (from_solver >= 0)
+    close(from_solver);
+
+  if (pid > 0)
+    waitpid(pid, nullptr, 0);
+}
+
+void smt2_processt::send(const std::string &text)
+{
+  if (!started)
+    start();
+
+  for (std::size_t written = 0; ok && written < text.size();)
+  {
+    const ssize_t n =
+        write(to_solver, text.data() + written, text.size() - written);
+
+    if (n <= 0)
+      ok = false;
+    else
+      written += n;
+  }
+}
+
+std::string smt2_processt::query(const std::string &commands)
+{
+  send(commands + "(echo \"" + response_end + "\")\n");
+
+  std::string response;
+
+  while (ok)
+  {
+    const std::size_t end = pending.find('\n');
+
+    if (end == std::string::npos)
+    {
+      char buffer[4096];
+      const ssize_t n = read(from_solver, buffer, sizeof(buffer));
+
+      if (n <= 0)
+        ok = false;
+      else
+        pending.append(buffer, n);
+
+      continue;
+    }
+
+    const std::string line = pending.substr(0, end);
+    pending.erase(0, end + 1);
+
+    if (line == response_end)
+      return response;
+
+    response += line;
+    response += '\n';
+  }
+
+  return response;
+}
+
+smt2_sessiont::smt2_sessiont(
+    const namespacet &_ns,
+    const std::string &_logic,
+    smt2_processt &_process,
+    message_handlert &_message_handler)
+    : smt2_dect(
+          _ns,
+          "fastsynth",
+          "generated by fastsynth",
+          _logic,
+          smt2_dect::solvert::Z3),
+      process(_process)
+{
+  set_message_handler(_message_handler);
+
+  // drops the declarations and definitions of the earlier sessions,
+  // which the state of smt2_convt does not know about
+  if (process.used())
+    unsent = "(reset)\n";
+
+  hash.add("z3 session\n");
+}
+
+void smt2_sessiont::flush()
+{
+  const std::string commands = stringstream.str();
+  stringstream.str(std::string());
+
+  hash.add(commands);
+  unsent += commands;
+
+  if (query_capture().enabled())
+    transcript += commands;
+}
+
+std::string smt2_sessiont::query(const std::string &commands)
+{
+  const std::string response = process.query(unsent + commands);
+  unsent.clear();
+  return response;
+}
+
+decision_proceduret::resultt smt2_sessiont::dec_solve()
+{
+  flush();
+
+  // checks do not change the state of the solver, hence are not
+  // part of the hash of the later queries
+  out << "(check-sat-assuming (";
+  for (const auto &l : assumptions)
+  {
+    out << ' ';
+    convert_literal(l);
+  }
+  out << "))\n";
+
+  const std::string check = stringstream.str();
+  stringstream.str(std::string());
+
+  query_hasht query_hash = hash;
+  query_hash.add(check);
+
+  std::string response;
+
+  if (!query_cache().lookup(query_hash, response))
+  {
+    const auto start_time = std::chrono::steady_clock::now();
+    response = query(check);
+    const std::chrono::duration<double> seconds =
+        std::chrono::steady_clock::now() - start_time;
+
+    // replayed as a whole, with the queries before as assertions only
+    query_capture().capture(
+        query_capture().role,
+        "smt2",
+        transcript + check,
+        response == "sat\n" || response == "unsat\n"
+            ? response.substr(0, response.size() - 1)
+            : "error",
+        seconds.count());
+
+    if (response == "sat\n")
+    {
+      for (const auto &id : smt2_identifiers)
+        out << "(get-value (|" << id << "|))\n";
+
+      const std::string get_values = stringstream.str();
+      stringstream.str(std::string());
+
+      response += query(get_values);
+    }
+
+    if (!process.is_ok())
+    {
+      error() << "SMT solver process failed" << eom;
+      return resultt::D_ERROR;
+    }
+
+    if (response == "unsat\n" || response.compare(0, 4, "sat\n") == 0)
+      query_cache().store(query_hash, response);
+  }
+
+  if (response == "unsat\n")
+    return resultt::D_UNSATISFIABLE;
+
+  if (response.compare(0, 4, "sat\n") != 0)
+  {
+    error() << "SMT solver: " << response << eom;
+    return resultt::D_ERROR;
+  }
+
+  std::istringstream values(response);
+  return read_result(values);
+}
+
+void smt2_sessiont::define_function(
+    const symbol_exprt &function,
+    const std::vector<symbol_exprt> &parameters,
+    const exprt &body)
+{
+  // declares the symbols of the body, and the parameters, which the
+  // bound variables of the definition shadow
+  find_symbols(body);
+
+  // applications must not declare the function again
+  const irep_idt &identifier = function.get_identifier();
+  identifier_map[identifier].type = function.type();
+
+  out << "(define-fun |" << convert_identifier(identifier) << "| (";
+
+  for (const auto &p : parameters)
+  {
+    out << " (|" << convert_identifier(p.get_identifier()) << "| ";
+    convert_type(p.type());
+    out << ')';
+  }
+
+  out << ") ";
+  convert_type(body.type());
+  out << ' ';
+  convert_expr(body);
+  out << ")\n";
+}
@@ -0,0 +1,102 @@
+#ifndef CPROVER_FASTSYNTH_SMT2_SESSION_H_
+#define CPROVER_FASTSYNTH_SMT2_SESSION_H_
+
+#include "query_cache.h"
+
+#include <solvers/smt2/smt2_dec.h>
+
+#include <sys/types.h>
+
+/// SMT-LIB2 solver process, started on first use. Commands are sent
+/// over a pipe. Sessions run on it in turn, see smt2_sessiont.
+class smt2_processt
+{
+public:
+  smt2_processt();
+  ~smt2_processt();
+
+  /// Sends text to the solver, starting it if needed.
+  void send(const std::string &);
+
+  /// Sends \p commands and returns the solver's response to them.
+  std::string query(const std::string &commands);
+
+  /// False once the solver has failed to start or to respond.
+  bool is_ok() const
+  {
+    return ok;
+  }
+
+  /// Whether commands have been sent.
+  bool used() const
+  {
+    return started;
+  }
+
+protected:
+  /// Whether start() was called.
+  bool started;
+
+  pid_t pid;
+
+  /// Pipes to the solver's standard input and from its standard output.
+  int to_solver, from_solver;
+
+  /// Output of the solver not yet returned by query().
+  std::string pending;
+
+  bool ok;
+
+  void start();
+};
+
+/// Decision procedure that sends its queries to an smt2_processt. Each
+/// query only sends what was added since the last one and checks the
+/// assumptions with check-sat-assuming.
+/// A session starts with a reset of the process if an earlier session
+/// used it, so that sessions share the process but no declarations.
+/// A query is looked up in query_cache() by all commands since the
+/// start of the session; the commands are only sent once a query is
+/// not found.
+class smt2_sessiont:public smt2_dect
+{
+public:
+  smt2_sessiont(
+    const namespacet &_ns,
+    const std::string &_logic,
+    smt2_processt &_process,
+    message_handlert &_message_handler);
+
+  resultt dec_solve() override;
+
+  /// Defines a function with define-fun, so that applications of
+  /// \p function share its body instead of repeating it.
+  /// The symbols of the body other than the parameters are declared
+  /// globally.
+  void define_function(
+    const symbol_exprt &function,
+    const std::vector<symbol_exprt> &parameters,
+    const exprt &body);
+
+protected:
+  smt2_processt &process;
+
+  /// Commands not yet sent to the solver.
+  std::string unsent;
+
+  /// Hash of the commands so far, without the queries answered by the
+  /// cache and the requests for values.
+  query_hasht hash;
+
+  /// The same commands, if query_capture() is enabled.
+  std::string transcript;
+
+  /// Moves the commands written so far to unsent.
+  void flush();
+
+  /// Sends the unsent commands followed by \p commands and returns the
+  /// solver's response to them.
+  std::string query(const std::string &commands);
+};
+
+#endif /* CPROVER_FASTSYNTH_SMT2_SESSION_H_ */
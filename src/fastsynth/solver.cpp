@@ -1,7 +1,10 @@
 #include "solver.h"
+#include "cached_smt2_dec.h"
+#include "portfolio_sat.h"
+#include "query_cache.h"
+#include "query_capture.h"
+#include "synth_bv.h"
 
-#include <solvers/sat/satcheck.h>
-#include <solvers/flattening/bv_pointers.h>
 #include <solvers/smt2/smt2_dec.h>
 #include <solvers/smt2/smt2_conv.h>
 
@@ -9,7 +12,10 @@ solvert::solvert(
     bool use_smt,
     const std::string &logic,
     const namespacet &_ns,
-    message_handlert &message_handler)
+    message_handlert &message_handler,
+    bool pointers,
+    const std::string &sat_solver,
+    std::size_t portfolio)
 {
   if (use_smt)
   {
@@ -18,16 +24,24 @@ solvert::solvert(
     // smt2_conv->set_message_handler(message_handler);
     // decision_procedure = move(smt2_dec);
 
-    std::unique_ptr<smt2_dect> smt2_dec(new smt2_dect(
-        _ns, "fastsynth", "created by fastsynth", logic, smt2_dect::solvert::Z3));
-    smt2_dec->set_message_handler(message_handler);
-    decision_procedure = move(smt2_dec);
+    if (query_cache().enabled() || query_capture().enabled())
+    {
+      decision_procedure = std::unique_ptr<decision_proceduret>(
+          new cached_smt2_dect(_ns, logic, message_handler));
+    }
+    else
+    {
+      std::unique_ptr<smt2_dect> smt2_dec(new smt2_dect(
+          _ns, "fastsynth", "created by fastsynth", logic, smt2_dect::solvert::Z3));
+      smt2_dec->set_message_handler(message_handler);
+      decision_procedure = move(smt2_dec);
+    }
   }
   else
   {
-    prop = std::unique_ptr<propt>(new satcheckt(message_handler));
+    prop = new_sat_portfolio(sat_solver, portfolio, message_handler);
 
-    decision_procedure = std::unique_ptr<decision_proceduret>(
-        new bv_pointerst(_ns, *prop, message_handler));
+    decision_procedure =
+        new_flattening(_ns, *prop, message_handler, pointers);
   }
 }
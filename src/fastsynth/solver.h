@@ -13,11 +13,19 @@ public:
     return *decision_procedure;
   }
 
+  /// \param pointers Whether the formulas may have pointers, which
+  ///   need bv_pointerst; see new_flattening.
+  /// \param sat_solver SAT back end, see new_sat_solver.
+  /// \param portfolio Number of copies of each query to run in
+  ///   parallel, see portfolio_satt.
   solvert(
     bool use_smt,
     const std::string &logic,
     const namespacet &,
-    message_handlert &);
+    message_handlert &,
+    bool pointers = true,
+    const std::string &sat_solver = "",
+    std::size_t portfolio = 1);
 
 protected:
   std::unique_ptr<propt> prop;
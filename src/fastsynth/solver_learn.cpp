@@ -1,13 +1,30 @@
-#include <solvers/flattening/bv_pointers.h>
-#include <solvers/sat/satcheck.h>
-
-#include <solvers/smt2/smt2_dec.h>
-
 #include <langapi/language_util.h>
 
+#include <util/expr_iterator.h>
+
+#include "bool_encoding.h"
+#include "portfolio_sat.h"
+#include "sat_solver.h"
+#include "smt2_session.h"
+#include "synth_bv.h"
 #include "synth_encoding.h"
 #include "solver_learn.h"
 #include <iostream>
+
+/// Checks whether any of the given expressions involves an array.
+/// \param expressions Expressions to search.
+/// \return True if an array-typed subexpression was found.
+template <class containert>
+static bool has_array_type(const containert &expressions)
+{
+  for (const exprt &e : expressions)
+    for (auto it(e.unique_depth_cbegin()); it != e.unique_depth_cend(); ++it)
+      if (it->type().id() == ID_array)
+        return true;
+
+  return false;
+}
+
 solver_learn_baset::solver_learn_baset(
     const namespacet &_ns,
     const problemt &_problem,
@@ -61,10 +78,26 @@ solver_learnt::solver_learnt(
     const problemt &_problem,
     message_handlert &_message_handler) : solver_learn_baset(_ns, _problem, _message_handler),
                                           program_size(1u),
-                                          array_size(10u)
+                                          array_size(10u),
+                                          use_cnf_cache(
+                                              !has_array_type(_problem.free_variables) &&
+                                              !has_array_type(_problem.constraints) &&
+                                              !has_array_type(_problem.side_conditions) &&
+                                              !has_pointer_type(_problem)),
+                                          use_pointers(has_pointer_type(_problem)),
+                                          use_smt(false),
+                                          sat_portfolio(1)
 {
 }
 
+solver_learnt::~solver_learnt()
+{
+  // the solver refers to the clause list
+  cnf_bool_encoding.reset();
+  cnf_solver.reset();
+  cnf.reset();
+}
+
 void solver_learnt::set_program_size(const size_t program_size)
 {
   this->program_size = program_size;
@@ -80,31 +113,42 @@ decision_proceduret::resultt solver_learnt::operator()()
 
   if (use_smt)
   {
-    smt2_dect solver(
-        ns, "fastsynth", "generated by fastsynth",
-        logic, smt2_dect::solvert::Z3);
-    solver.set_message_handler(get_message_handler());
-
-    return this->operator()(solver);
+    return solve_smt();
+  }
+  else if (use_cnf_cache)
+  {
+    return solve_cnf();
   }
   else
   {
-    satcheckt satcheck(get_message_handler());
+    const auto satcheck =
+        new_sat_portfolio(sat_solver, sat_portfolio, get_message_handler());
+
+    const auto solver =
+        new_flattening(ns, *satcheck, get_message_handler(), use_pointers);
+
+    const auto encoding = setup_encoding();
+    encode(*encoding, *solver);
 
-    bv_pointerst solver(ns, satcheck, get_message_handler());
+    for (const auto &l : phase_literals(*encoding, *solver))
+      set_phase(*satcheck, l);
 
-    return this->operator()(solver);
+    return solve(*encoding, *solver);
   }
 }
 
 decision_proceduret::resultt solver_learnt::operator()(
     decision_proceduret &solver)
 {
-  synth_encodingt synth_encoding;
-  synth_encoding.program_size = program_size;
-  synth_encoding.enable_bitwise = enable_bitwise;
-  synth_encoding.literals = problem.literals;
-  synth_encoding.array_size = array_size;
+  const auto encoding = setup_encoding();
+  encode(*encoding, solver);
+  return solve(*encoding, solver);
+}
+
+void solver_learnt::encode(
+    synth_encodingt &synth_encoding,
+    decision_proceduret &solver)
+{
   status() << "ARRAY SIZE " << array_size << eom;
 
   if (counterexamples.empty())
@@ -128,7 +172,12 @@ decision_proceduret::resultt solver_learnt::operator()(
       counter++;
     }
   }
+}
 
+decision_proceduret::resultt solver_learnt::solve(
+    const synth_encodingt &synth_encoding,
+    decision_proceduret &solver)
+{
   const decision_proceduret::resultt result = solver();
 
   switch (result)
@@ -140,6 +189,7 @@ decision_proceduret::resultt solver_learnt::operator()(
 #endif
 
     last_solution = synth_encoding.get_solution(solver);
+    record_phases(synth_encoding, solver);
     break;
 
   case decision_proceduret::resultt::D_UNSATISFIABLE:
@@ -150,6 +200,256 @@ decision_proceduret::resultt solver_learnt::operator()(
   return result;
 }
 
+void solver_learnt::record_phases(
+    const synth_encodingt &encoding,
+    const decision_proceduret &solver)
+{
+  for (const auto &v : encoding.program_variables())
+    phases[v.get_identifier()] = solver.get(v);
+}
+
+bvt solver_learnt::phase_literals(
+    const synth_encodingt &encoding,
+    boolbvt &solver) const
+{
+  bvt result;
+
+  for (const auto &v : encoding.program_variables())
+  {
+    const auto p_it = phases.find(v.get_identifier());
+
+    // the word type may have changed, e.g., by bit-width scaling
+    if (p_it == phases.end() || p_it->second.type() != v.type())
+      continue;
+
+    const typet &type = v.type();
+
+    if (type.id() == ID_bool)
+    {
+      const literalt l = solver.convert(v);
+      result.push_back(p_it->second.is_true() ? l : !l);
+    }
+    else if (type.id() == ID_unsignedbv || type.id() == ID_signedbv)
+    {
+      const bvt bits = solver.convert_bv(v);
+      const bvt values = solver.convert_bv(p_it->second);
+
+      for (std::size_t i = 0; i < bits.size() && i < values.size(); i++)
+        if (values[i].is_constant())
+          result.push_back(values[i].is_true() ? bits[i] : !bits[i]);
+    }
+  }
+
+  return result;
+}
+
+std::unique_ptr<synth_encodingt> solver_learnt::new_encoding() const
+{
+  return std::unique_ptr<synth_encodingt>(new synth_encodingt());
+}
+
+std::unique_ptr<synth_encodingt> solver_learnt::setup_encoding() const
+{
+  auto encoding = new_encoding();
+  encoding->program_size = program_size;
+  encoding->enable_bitwise = enable_bitwise;
+  encoding->operator_budget = operator_budget;
+  encoding->distinct_integer_constants = distinct_integer_constants;
+  encoding->literals = problem.literals;
+  encoding->array_size = array_size;
+  return encoding;
+}
+
+void solver_learnt::start_encoding(persistent_encodingt &state) const
+{
+  state.encoding = setup_encoding();
+  state.encoding->growable = true;
+  state.program_size = program_size;
+  state.array_size = array_size;
+  state.literals = problem.literals.size();
+  state.counterexamples = 0;
+  state.base_problem = false;
+}
+
+bool solver_learnt::needs_reset(const persistent_encodingt &state) const
+{
+  // the base problem is only used as long as there are no counterexamples
+  return !state.encoding || program_size < state.program_size ||
+         array_size != state.array_size ||
+         state.literals != problem.literals.size() ||
+         (state.base_problem && !counterexamples.empty());
+}
+
+bool solver_learnt::extend(
+    persistent_encodingt &state,
+    decision_proceduret &solver)
+{
+  if (program_size > state.program_size)
+  {
+    // encode the new instructions only
+    state.encoding->constraints.clear();
+
+    if (!state.encoding->grow(program_size))
+      return false;
+
+    for (const auto &c : state.encoding->constraints)
+      solver.set_to_true(c);
+
+    state.program_size = program_size;
+  }
+
+  if (counterexamples.empty())
+  {
+    if (!state.base_problem)
+    {
+      state.encoding->suffix = "$ce";
+      state.encoding->constraints.clear();
+      status() << "Start to add problem \n";
+      add_problem(*state.encoding, solver);
+      state.base_problem = true;
+    }
+
+    return true;
+  }
+
+  for (; state.counterexamples < counterexamples.size();
+       state.counterexamples++)
+  {
+    state.encoding->suffix = "$ce" + std::to_string(state.counterexamples);
+    state.encoding->constraints.clear();
+    add_counterexample(
+        counterexamples[state.counterexamples], *state.encoding, solver);
+
+    add_problem(*state.encoding, solver);
+  }
+
+  return true;
+}
+
+void solver_learnt::reset_cnf()
+{
+  cnf_bool_encoding.reset();
+  cnf_solver.reset();
+  cnf = std::unique_ptr<cnf_clause_list_assignmentt>(
+      new cnf_clause_list_assignmentt(get_message_handler()));
+  cnf_solver =
+      new_flattening(ns, *cnf, get_message_handler(), use_pointers);
+  cnf_bool_encoding = std::unique_ptr<bool_encodingt>(
+      new bool_encodingt(*cnf_solver, *cnf));
+
+  start_encoding(cnf_state);
+  cnf_state.encoding->clauses = cnf_bool_encoding.get();
+}
+
+void solver_learnt::extend_cnf()
+{
+  if (!cnf || needs_reset(cnf_state))
+    reset_cnf();
+
+  if (!extend(cnf_state, *cnf_solver))
+  {
+    reset_cnf();
+    extend(cnf_state, *cnf_solver);
+  }
+}
+
+decision_proceduret::resultt solver_learnt::solve_cnf()
+{
+  extend_cnf();
+
+  statistics() << "Replaying " << cnf->no_clauses() << " clauses over "
+               << cnf->no_variables() << " variables" << eom;
+
+  if (auto flattening = dynamic_cast<const synth_bvt *>(cnf_solver.get()))
+    statistics() << "Instantiated " << flattening->instances
+                 << " operation templates" << eom;
+
+  // only functions with a Boolean word type are encoded as gates
+  if (cnf_bool_encoding->size() != 0)
+    statistics() << "Shared " << cnf_bool_encoding->hits << " Boolean gates"
+                 << eom;
+
+  // the outputs follow the last instruction of the current size
+  const literalt size_literal =
+      cnf_solver->convert(program_size_selector(cnf_state.program_size));
+
+  // before copying, as converting may add to cnf
+  const bvt phase_literals =
+      this->phase_literals(*cnf_state.encoding, *cnf_solver);
+
+  const auto satcheck =
+      new_sat_portfolio(sat_solver, sat_portfolio, get_message_handler());
+  cnf->copy_to(*satcheck);
+  satcheck->l_set_to_true(size_literal);
+
+  std::size_t phases_set = 0;
+  for (const auto &l : phase_literals)
+    if (set_phase(*satcheck, l))
+      phases_set++;
+
+  if (phases_set != 0)
+    statistics() << "Phase hints for " << phases_set << " variables" << eom;
+
+  switch (satcheck->prop_solve())
+  {
+  case propt::resultt::P_SATISFIABLE:
+    // make the model visible to the flattening
+    cnf->copy_assignment_from(*satcheck);
+#if 1
+    cnf_solver->print_assignment(debug());
+    debug() << eom;
+#endif
+
+    last_solution = cnf_state.encoding->get_solution(*cnf_solver);
+    record_phases(*cnf_state.encoding, *cnf_solver);
+    return decision_proceduret::resultt::D_SATISFIABLE;
+
+  case propt::resultt::P_UNSATISFIABLE:
+    return decision_proceduret::resultt::D_UNSATISFIABLE;
+
+  case propt::resultt::P_ERROR:
+    break;
+  }
+
+  return decision_proceduret::resultt::D_ERROR;
+}
+
+void solver_learnt::reset_smt()
+{
+  if (!smt_process)
+    smt_process = std::unique_ptr<smt2_processt>(new smt2_processt());
+
+  smt_session = std::unique_ptr<smt2_sessiont>(
+      new smt2_sessiont(ns, logic, *smt_process, get_message_handler()));
+
+  start_encoding(smt_state);
+  smt_state.encoding->definitions = smt_session.get();
+}
+
+decision_proceduret::resultt solver_learnt::solve_smt()
+{
+  if (!smt_session || needs_reset(smt_state))
+    reset_smt();
+
+  if (!extend(smt_state, *smt_session))
+  {
+    reset_smt();
+    extend(smt_state, *smt_session);
+  }
+
+  // the outputs follow the last instruction of the current size
+  const literalt size_literal =
+      smt_session->convert(program_size_selector(smt_state.program_size));
+  smt_session->set_assumptions({size_literal});
+
+  const decision_proceduret::resultt result = (*smt_session)();
+
+  if (result == decision_proceduret::resultt::D_SATISFIABLE)
+    last_solution = smt_state.encoding->get_solution(*smt_session);
+
+  return result;
+}
+
 solutiont solver_learnt::get_solution() const
 {
   return last_solution;
@@ -2,6 +2,11 @@
 #define CPROVER_FASTSYNTH_PROP_LEARN_H_
 
 #include "learn.h"
+#include "synth_encoding.h"
+
+#include <solvers/sat/cnf_clause_list.h>
+
+#include <memory>
 
 class solver_learn_baset:public learnt
 {
@@ -51,6 +56,112 @@ class solver_learnt:public solver_learn_baset
   /// Solution created in the last invocation of solver_learnt::operator()().
   solutiont last_solution;
 
+  /// Whether counterexample instances are bit-blasted once into cnf and
+  /// replayed into a fresh SAT solver, instead of being encoded again
+  /// on every call. Not used with --smt, or with array- or pointer-typed
+  /// problems, as the array theory and the pointer flattening add their
+  /// constraints only when solving.
+  bool use_cnf_cache;
+
+  /// Encoding of the instances that is extended across calls. Instance
+  /// numbers and symbol names stay stable; when the program size grows,
+  /// only the new instructions are encoded.
+  struct persistent_encodingt
+  {
+    std::unique_ptr<synth_encodingt> encoding;
+
+    /// Program and array size the encoding has been built for.
+    std::size_t program_size = 0;
+    std::size_t array_size = 0;
+
+    /// Number of literals the encoding has been built for; literals may
+    /// be added lazily.
+    std::size_t literals = 0;
+
+    /// Number of counterexamples already encoded.
+    std::size_t counterexamples = 0;
+
+    /// True if the encoding holds the base problem without
+    /// counterexamples.
+    bool base_problem = false;
+  };
+
+  /// Encoding of the instances in cnf.
+  persistent_encodingt cnf_state;
+
+  /// Clauses of all instances encoded so far, plus the assignment of the
+  /// last successful solver call.
+  std::unique_ptr<cnf_clause_list_assignmentt> cnf;
+
+  /// Whether the problem needs the pointer flattening.
+  bool use_pointers;
+
+  /// Flattens the instances into cnf.
+  std::unique_ptr<class boolbvt> cnf_solver;
+
+  /// Emits the instructions of Boolean functions into cnf directly.
+  std::unique_ptr<class bool_encodingt> cnf_bool_encoding;
+
+  /// With --smt, the instances are asserted into a solver session that
+  /// is kept across calls, on a process that is kept across sessions.
+  persistent_encodingt smt_state;
+  std::unique_ptr<class smt2_processt> smt_process;
+  std::unique_ptr<class smt2_sessiont> smt_session;
+
+  /// Starts a new encoding for the current program size.
+  void start_encoding(persistent_encodingt &) const;
+
+  /// Whether the encoding must be started again: the program size has
+  /// shrunk, the literals have changed, or the base problem is to be
+  /// replaced by counterexamples.
+  bool needs_reset(const persistent_encodingt &) const;
+
+  /// Adds the new instructions and the counterexamples not yet encoded.
+  /// \return False if the encoding cannot grow to the program size.
+  bool extend(persistent_encodingt &, decision_proceduret &);
+
+  /// Discards the cached clauses and starts a new encoding.
+  void reset_cnf();
+
+  /// Brings cnf up to date with the counterexamples.
+  void extend_cnf();
+
+  /// Replays cnf into a new SAT solver and solves it.
+  decision_proceduret::resultt solve_cnf();
+
+  /// Starts a new solver process and encoding.
+  void reset_smt();
+
+  /// Sends the new counterexamples to the solver process and solves.
+  decision_proceduret::resultt solve_smt();
+
+  /// Creates an encoding configured for the current program size.
+  std::unique_ptr<synth_encodingt> setup_encoding() const;
+
+  /// Values of the program variables in the last solution, by name,
+  /// which stays the same across encodings. The next query tries these
+  /// first, as a new candidate is usually a small edit of the last one.
+  std::map<irep_idt, exprt> phases;
+
+  /// Remembers the values of the program variables in the model.
+  void record_phases(const synth_encodingt &, const decision_proceduret &);
+
+  /// Literals that hold if the program variables of the encoding have
+  /// their values in phases.
+  bvt phase_literals(const synth_encodingt &, class boolbvt &) const;
+
+  /// Adds the base problem or the counterexamples to the solver.
+  void encode(synth_encodingt &, decision_proceduret &);
+
+  /// Solves, and records the solution if there is one.
+  decision_proceduret::resultt solve(
+    const synth_encodingt &,
+    decision_proceduret &);
+
+protected:
+  /// Creates the encoding to build the constraint with.
+  virtual std::unique_ptr<synth_encodingt> new_encoding() const;
+
 public:
   /// Creates a non-incremental learner.
   /// \param msg \see msg solver_learnt::msg
@@ -61,9 +172,18 @@ public:
     const problemt &,
     message_handlert &);
 
+  ~solver_learnt();
+
   bool use_smt;
   std::string logic;
 
+  /// SAT back end, see new_sat_solver().
+  std::string sat_solver;
+
+  /// Number of copies of each query to run in parallel, see
+  /// portfolio_satt.
+  std::size_t sat_portfolio;
+
   /// \see learnt::set_program_size(size_t)
   void set_program_size(size_t program_size) override;
   void set_array_size(std::size_t array_size) override;
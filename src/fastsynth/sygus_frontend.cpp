@@ -85,6 +85,37 @@ int sygus_frontend(const cmdlinet &cmdline)
   cegis.enable_division = cmdline.isset("enable-division");
   cegis.logic = parser.logic;
 
+  if (cmdline.isset("width-scaling"))
+    cegis.scaled_width = std::stoul(cmdline.get_value("width-scaling"));
+
+  if (cmdline.isset("learner"))
+    cegis.learner_name = cmdline.get_value("learner");
+
+  cegis.exhaustive_verify = cmdline.isset("exhaustive-verify");
+  cegis.parallel_verify = cmdline.isset("parallel-verify");
+
+  if (cmdline.isset("verify-jobs"))
+    cegis.verify_jobs = std::stoul(cmdline.get_value("verify-jobs"));
+
+  if (cmdline.isset("sat-solver"))
+    cegis.learner_sat_solver = cegis.verifier_sat_solver =
+        cmdline.get_value("sat-solver");
+
+  if (cmdline.isset("learner-sat-solver"))
+    cegis.learner_sat_solver = cmdline.get_value("learner-sat-solver");
+
+  if (cmdline.isset("verifier-sat-solver"))
+    cegis.verifier_sat_solver = cmdline.get_value("verifier-sat-solver");
+
+  if (cmdline.isset("sat-portfolio"))
+    cegis.sat_portfolio = std::stoul(cmdline.get_value("sat-portfolio"));
+
+  cegis.use_fm = cmdline.isset("fm");
+  cegis.theory_constants = cmdline.isset("cegis-t") || cegis.use_fm;
+
+  if (cmdline.isset("operator-budget"))
+    cegis.operator_budget = std::stoul(cmdline.get_value("operator-budget"));
+
   problemt problem;
   // for (auto &c : parser.constraints)
   //   parser.expand_function_applications(c, false);
@@ -108,8 +139,14 @@ int sygus_frontend(const cmdlinet &cmdline)
   for (auto &c : problem.constraints)
     parser.expand_function_applications(c);
 
-  if (cmdline.isset("literals"))
-    add_literals(problem);
+  if (cmdline.isset("literals") || cmdline.isset("lazy-literals"))
+  {
+    const std::size_t max_literals =
+        cmdline.isset("max-literals")
+            ? std::stoul(cmdline.get_value("max-literals"))
+            : 8;
+    add_literals(problem, max_literals, cmdline.isset("lazy-literals"));
+  }
 
 #if 0
   sygus_interfacet sygus_interface;
@@ -1,4 +1,7 @@
 #include "sygus_interface.h"
+#include "query_cache.h"
+#include "query_capture.h"
+#include <chrono>
 #include <util/expr.h>
 #include <iostream>
 #include <util/tempfile.h>
@@ -513,6 +516,19 @@ decision_proceduret::resultt sygus_interfacet::solve(const int timeout)
       << query << std::endl;
 #endif
 
+  // the response depends on the time the solver is given
+  query_hasht hash;
+  hash.add("cvc4 " + integer2string(timeout) + "\n");
+  hash.add(query);
+
+  std::string response;
+
+  if (query_cache().lookup(hash, response))
+  {
+    std::istringstream in(response);
+    return read_result(in);
+  }
+
   temporary_filet
       temp_file_problem("sygus_problem_", ""),
       temp_file_stdout("sygus_stdout_", ""),
@@ -534,17 +550,43 @@ decision_proceduret::resultt sygus_interfacet::solve(const int timeout)
             "--sygus-active-gen=enum", "--nl-ext-tplanes",
             temp_file_problem()};
 
+  const auto start_time = std::chrono::steady_clock::now();
+
   int res =
       run(argv[0], argv, stdin_filename, temp_file_stdout(), temp_file_stderr());
+
+  const std::chrono::duration<double> seconds =
+      std::chrono::steady_clock::now() - start_time;
+
+  // the result is only known once the response is parsed
+  query_capture().capture(
+      "cvc4", "sygus", query, res == 0 ? "done" : "error", seconds.count());
   if (res < 0)
   {
     return decision_proceduret::resultt::D_ERROR;
   }
-  else
+  else if (res != 0 || !query_cache().enabled())
   {
     std::ifstream in(temp_file_stdout());
     return read_result(in);
   }
+  else
+  {
+    std::ifstream out(temp_file_stdout());
+    std::ostringstream contents;
+    contents << out.rdbuf();
+    response = contents.str();
+
+    std::istringstream in(response);
+    const decision_proceduret::resultt solver_result = read_result(in);
+
+    // only a solution is certain to come again; unknown and
+    // unparseable output may be down to the time limit
+    if (solver_result == decision_proceduret::resultt::D_SATISFIABLE)
+      query_cache().store(hash, response);
+
+    return solver_result;
+  }
 }
 
 void sygus_interfacet::clear()
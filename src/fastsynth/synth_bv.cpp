@@ -0,0 +1,181 @@
+#include "synth_bv.h"
+
+#include <solvers/flattening/bv_pointers.h>
+#include <solvers/flattening/bv_utils.h>
+#include <solvers/sat/cnf_clause_list.h>
+
+#include <util/expr_iterator.h>
+
+bool synth_bvt::has_template(const exprt &expr)
+{
+  if (expr.id() != ID_plus &&
+      expr.id() != ID_minus &&
+      expr.id() != ID_mult &&
+      expr.id() != ID_unary_minus)
+    return false;
+
+  if (expr.type().id() != ID_signedbv && expr.type().id() != ID_unsignedbv)
+    return false;
+
+  if (expr.operands().empty() ||
+      (expr.id() == ID_unary_minus) != (expr.operands().size() == 1) ||
+      (expr.id() == ID_minus && expr.operands().size() != 2))
+    return false;
+
+  for (const auto &op : expr.operands())
+    if (op.type() != expr.type())
+      return false;
+
+  return true;
+}
+
+synth_bvt::circuit_templatet synth_bvt::build_template(
+    const exprt &shape) const
+{
+  null_message_handlert null_message_handler;
+  cnf_clause_listt cnf(null_message_handler);
+  bv_utilst utils(cnf);
+
+  circuit_templatet result;
+  result.inputs = 0;
+
+  std::vector<bvt> operands;
+
+  for (const auto &op : shape.operands())
+  {
+    const std::size_t width = boolbv_width(op.type());
+    operands.push_back(cnf.new_variables(width));
+    result.inputs += width;
+  }
+
+  const auto representation = shape.type().id() == ID_signedbv
+                                  ? bv_utilst::representationt::SIGNED
+                                  : bv_utilst::representationt::UNSIGNED;
+
+  if (shape.id() == ID_unary_minus)
+    result.outputs = utils.negate(operands[0]);
+  else if (shape.id() == ID_minus)
+    result.outputs = utils.sub(operands[0], operands[1]);
+  else
+  {
+    result.outputs = operands[0];
+
+    for (std::size_t i = 1; i < operands.size(); i++)
+      result.outputs =
+          shape.id() == ID_plus
+              ? utils.add(result.outputs, operands[i])
+              : utils.multiplier(result.outputs, operands[i], representation);
+  }
+
+  result.variables = cnf.no_variables();
+  result.clauses.assign(cnf.get_clauses().begin(), cnf.get_clauses().end());
+
+  return result;
+}
+
+bvt synth_bvt::instantiate(
+    const circuit_templatet &circuit,
+    const bvt &inputs)
+{
+  std::vector<literalt> renaming(circuit.variables);
+
+  for (std::size_t i = 0; i < circuit.inputs; i++)
+    renaming[i + 1] = inputs[i];
+
+  for (std::size_t v = circuit.inputs + 1; v < circuit.variables; v++)
+    renaming[v] = prop.new_variable();
+
+  const auto rename = [&renaming](literalt l) {
+    return l.is_constant() ? l : renaming[l.var_no()].cond_negation(l.sign());
+  };
+
+  bvt clause;
+
+  for (const auto &c : circuit.clauses)
+  {
+    clause.clear();
+    for (const auto &l : c)
+      clause.push_back(rename(l));
+
+    prop.lcnf(clause);
+  }
+
+  bvt outputs;
+  outputs.reserve(circuit.outputs.size());
+
+  for (const auto &l : circuit.outputs)
+    outputs.push_back(rename(l));
+
+  instances++;
+
+  return outputs;
+}
+
+bvt synth_bvt::convert_bitvector(const exprt &expr)
+{
+  if (!has_template(expr))
+    return boolbvt::convert_bitvector(expr);
+
+  bvt inputs;
+
+  for (const auto &op : expr.operands())
+  {
+    const bvt &op_bv = convert_bv(op);
+    inputs.insert(inputs.end(), op_bv.begin(), op_bv.end());
+  }
+
+  // bv_utilst folds constant inputs, which a template cannot
+  for (const auto &l : inputs)
+    if (l.is_constant())
+      return boolbvt::convert_bitvector(expr);
+
+  exprt shape = expr;
+  for (auto &op : shape.operands())
+    op = exprt(ID_nil, op.type());
+
+  auto it = templates.find(shape);
+
+  if (it == templates.end())
+    it = templates.emplace(shape, build_template(shape)).first;
+
+  return instantiate(it->second, inputs);
+}
+
+bool has_pointer_type(const problemt &problem)
+{
+  const auto has_pointer = [](const exprt &e) {
+    for (auto it(e.unique_depth_cbegin()); it != e.unique_depth_cend(); ++it)
+      if (it->type().id() == ID_pointer)
+        return true;
+
+    return false;
+  };
+
+  for (const auto &e : problem.free_variables)
+    if (has_pointer(e))
+      return true;
+
+  for (const auto &e : problem.side_conditions)
+    if (has_pointer(e))
+      return true;
+
+  for (const auto &e : problem.constraints)
+    if (has_pointer(e))
+      return true;
+
+  return false;
+}
+
+std::unique_ptr<boolbvt> new_flattening(
+    const namespacet &ns,
+    propt &prop,
+    message_handlert &message_handler,
+    bool pointers)
+{
+  if (pointers)
+    return std::unique_ptr<boolbvt>(
+        new bv_pointerst(ns, prop, message_handler));
+  else
+    return std::unique_ptr<boolbvt>(
+        new synth_bvt(ns, prop, message_handler));
+}
@@ -0,0 +1,75 @@
+#ifndef CPROVER_FASTSYNTH_SYNTH_BV_H_
+#define CPROVER_FASTSYNTH_SYNTH_BV_H_
+
+#include "cegis_types.h"
+
+#include <solvers/flattening/boolbv.h>
+
+#include <util/irep_hash.h>
+
+#include <memory>
+#include <unordered_map>
+
+/// Flattening for the formulas of fastsynth, which have no pointers.
+/// The arithmetic operators are bit-blasted once per shape, i.e.
+/// operator and operand types, into a circuit template; each further
+/// occurrence instantiates the template by renaming its literals,
+/// instead of going through bv_utilst again.
+class synth_bvt:public boolbvt
+{
+public:
+  synth_bvt(
+    const namespacet &_ns,
+    propt &_prop,
+    message_handlert &_message_handler):
+    boolbvt(_ns, _prop, _message_handler),
+    instances(0)
+  {
+  }
+
+  /// Number of operations encoded by instantiating a template.
+  std::size_t instances;
+
+protected:
+  bvt convert_bitvector(const exprt &) override;
+
+  /// Clauses of an operation over fresh input variables.
+  struct circuit_templatet
+  {
+    /// Number of input bits, variables 1 to inputs.
+    std::size_t inputs;
+
+    /// Number of variables, including the unused variable 0.
+    std::size_t variables;
+
+    std::vector<bvt> clauses;
+    bvt outputs;
+  };
+
+  /// Templates by shape: the operation with nil operands of the same
+  /// types.
+  std::unordered_map<exprt, circuit_templatet, irep_hash> templates;
+
+  /// Whether the operation is bit-blasted by a template.
+  static bool has_template(const exprt &);
+
+  circuit_templatet build_template(const exprt &shape) const;
+
+  /// Adds the clauses of a template for the given input bits.
+  /// \return The output bits.
+  bvt instantiate(const circuit_templatet &, const bvt &inputs);
+};
+
+/// Whether the problem mentions pointers, which synth_bvt does not
+/// handle.
+bool has_pointer_type(const problemt &);
+
+/// Flattening for fastsynth formulas: synth_bvt, or bv_pointerst if
+/// \p pointers is set.
+std::unique_ptr<boolbvt> new_flattening(
+  const namespacet &,
+  propt &,
+  message_handlert &,
+  bool pointers);
+
+#endif /* CPROVER_FASTSYNTH_SYNTH_BV_H_ */
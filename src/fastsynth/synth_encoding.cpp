@@ -1,3 +1,4 @@
+#include <util/arith_tools.h>
 #include <util/std_types.h>
 #include <util/config.h>
 #include <util/bv_arithmetic.h>
@@ -6,8 +7,8 @@
 #include "array_cegis.h"
 
 #include "synth_encoding.h"
-
-#define ARRAY_MAX 5
+#include "bool_encoding.h"
+#include "smt2_session.h"
 
 #include <algorithm>
 #include <iostream>
@@ -55,6 +56,186 @@ exprt promotion(const exprt &expr, const typet &t)
   return typecast_exprt(expr, t);
 }
 
+std::size_t operator_cost(const irep_idt &operation)
+{
+  if (operation == ID_plus)
+    return 1;
+
+  if (operation == ID_minus ||
+      operation == ID_unary_minus ||
+      operation == ID_bitand ||
+      operation == ID_bitor ||
+      operation == ID_bitxor ||
+      operation == ID_bitnot ||
+      operation == ID_not)
+    return 2;
+
+  if (is_predicate(operation) ||
+      operation == ID_shl ||
+      operation == ID_lshr)
+    return 3;
+
+  if (operation == ID_if ||
+      operation == "max" ||
+      operation == "min")
+    return 4;
+
+  return 5;
+}
+
+std::vector<irep_idt> binary_operations(
+    const typet &word_type,
+    bool enable_bitwise,
+    bool enable_division,
+    bool has_array_operand,
+    std::size_t operator_budget)
+{
+  static const irep_idt ops[] =
+      {ID_plus, ID_minus, ID_shl, ID_lshr,
+       ID_bitand, ID_bitor, ID_bitxor,
+       ID_le, ID_lt, ID_equal, ID_notequal, "max", "min", ID_div};
+
+  std::vector<irep_idt> result;
+
+  for (const auto operation : ops)
+  {
+    if (operator_cost(operation) > operator_budget)
+      continue;
+
+    if (!enable_bitwise || word_type.id() == ID_integer)
+      if (operation == ID_lshr ||
+          operation == ID_shl ||
+          operation == ID_bitand ||
+          operation == ID_bitor ||
+          operation == ID_bitxor)
+        continue;
+
+    if ((word_type.id() != ID_unsignedbv &&
+         word_type.id() != ID_signedbv) ||
+        !enable_division)
+      if (operation == ID_div)
+        continue;
+    if (operation == ID_index && !has_array_operand)
+      continue;
+
+    irep_idt final_operation = operation;
+
+    if (word_type.id() == ID_bool)
+    {
+      if (operation == ID_plus ||
+          operation == ID_minus ||
+          operation == ID_lshr ||
+          operation == ID_shl ||
+          operation == ID_lt ||
+          operation == ID_le ||
+          operation == ID_notequal || // we got bitxor
+          operation == ID_index ||
+          operation == "max" ||
+          operation == "min" ||
+          operation == ID_div)
+        continue;
+
+      if (operation == ID_bitand)
+        final_operation = ID_and;
+      else if (operation == ID_bitor)
+        final_operation = ID_or;
+      else if (operation == ID_bitxor)
+        final_operation = ID_xor;
+    }
+
+    result.push_back(final_operation);
+  }
+
+  return result;
+}
+
+std::vector<irep_idt> unary_operations(
+    const typet &word_type,
+    bool enable_bitwise,
+    std::size_t operator_budget)
+{
+  std::vector<irep_idt> candidates;
+
+  if (word_type.id() == ID_bool)
+    candidates.push_back(ID_not);
+  else
+  {
+    candidates.push_back(ID_unary_minus);
+
+    if (enable_bitwise && word_type.id() != ID_integer)
+      candidates.push_back(ID_bitnot);
+  }
+
+  std::vector<irep_idt> result;
+
+  for (const auto &operation : candidates)
+    if (operator_cost(operation) <= operator_budget)
+      result.push_back(operation);
+
+  return result;
+}
+
+bool is_commutative(const irep_idt &operation)
+{
+  return operation == ID_plus ||
+         operation == ID_bitand ||
+         operation == ID_bitor ||
+         operation == ID_bitxor ||
+         operation == ID_and ||
+         operation == ID_or ||
+         operation == ID_xor ||
+         operation == ID_equal ||
+         operation == ID_notequal ||
+         operation == "max" ||
+         operation == "min";
+}
+
+bool is_predicate(const irep_idt &operation)
+{
+  return operation == ID_le ||
+         operation == ID_lt ||
+         operation == ID_equal ||
+         operation == ID_notequal;
+}
+
+exprt binary_operation(
+    const irep_idt &operation,
+    const exprt &op0,
+    const exprt &op1,
+    const typet &word_type)
+{
+  if (operation == "max")
+  {
+    binary_predicate_exprt rel(op0, ID_ge, op1);
+    return if_exprt(rel, op0, op1);
+  }
+  else if (operation == "min")
+  {
+    binary_predicate_exprt rel(op0, ID_le, op1);
+    return if_exprt(rel, op0, op1);
+  }
+  else if (is_predicate(operation))
+  {
+    return promotion(
+        binary_exprt(op0, operation, op1, bool_typet()), word_type);
+  }
+  else
+    return binary_exprt(op0, operation, op1, word_type);
+}
+
+exprt unary_operation(
+    const irep_idt &operation,
+    const exprt &op,
+    const typet &word_type)
+{
+  if (operation == ID_not)
+    return not_exprt(op);
+  else if (operation == ID_bitnot)
+    return bitnot_exprt(op);
+  else
+    return unary_minus_exprt(op, word_type);
+}
+
 typet e_datat::compute_word_type()
 {
   typet result = return_type;
@@ -106,214 +287,223 @@ void e_datat::setup(
     else
       ++it;
 
+  if (use_definitions())
+    for (std::size_t i = 0; i < parameter_types.size(); i++)
+      parameters.push_back(symbol_exprt(
+          id2string(identifier) + "_param" + std::to_string(i),
+          parameter_types[i]));
+
   instructions.reserve(program_size);
   for (std::size_t pc = 0; pc < program_size; pc++)
   {
-    instructions.push_back(instructiont(pc, *this));
-    // array_instructions.push_back(instructiont(pc, *this));
+    add_instruction();
 
-    auto &instruction = instructions[pc];
-    // auto &array_instruction = array_instructions[pc];
+    if (use_definitions())
+      define_instruction(pc);
+  }
+}
 
-    // constant -- hardwired default, not an option
-    irep_idt const_val_id = id2string(identifier) + "_" + std::to_string(pc) + "_cval";
+void e_datat::add_instruction()
+{
+  const std::size_t pc = instructions.size();
+  const irep_idt &identifier = function_symbol.get_identifier();
 
-    if (word_type.id() == ID_integer)
-      instruction.constant_val = symbol_exprt("0", word_type);
-    else
-      instruction.constant_val = symbol_exprt(const_val_id, word_type);
+  instructions.push_back(instructiont(pc, *this));
+  // array_instructions.push_back(instructiont(pc, *this));
 
-    // one of the arguments or constants
-    // or array element of one of the arguments
-    for (std::size_t i = 0; i < arguments.size() + literals.size(); i++)
-    {
-      bool is_array = true;
+  auto &instruction = instructions[pc];
+  // auto &array_instruction = array_instructions[pc];
 
-      if (i < arguments.size())
-        is_array = (arguments[i].type().id() == ID_array);
+  // all selector names of this instruction share this prefix
+  const std::string pc_prefix =
+      id2string(identifier) + "_" + std::to_string(pc);
 
-      if (i > arguments.size() || !is_array)
-      {
-        irep_idt param_sel_id = id2string(identifier) + "_" +
-                                std::to_string(pc) + "_p" + std::to_string(i) +
-                                "sel";
-        auto &option = instruction.add_option(param_sel_id);
-        option.kind = instructiont::optiont::PARAMETER;
-        option.parameter_number = i;
-      }
-      else if (
-          i < arguments.size() && pc < arguments.size() && has_array_operand > 0)
+  // constant -- hardwired default, not an option
+  irep_idt const_val_id = pc_prefix + "_cval";
+
+  if (word_type.id() == ID_integer && !distinct_integer_constants)
+    instruction.constant_val = symbol_exprt("0", word_type);
+  else
+    instruction.constant_val = symbol_exprt(const_val_id, word_type);
+
+  // one of the arguments or constants
+  // or array element of one of the arguments
+  for (std::size_t i = 0; i < parameter_types.size() + literals.size(); i++)
+  {
+    // literals follow the parameters
+    const bool is_array =
+        i < parameter_types.size() && parameter_types[i].id() == ID_array;
+
+    if (i >= parameter_types.size() || !is_array)
+    {
+      irep_idt param_sel_id = pc_prefix + "_p" + std::to_string(i) + "sel";
+      auto &option = instruction.add_option(param_sel_id);
+      option.kind = instructiont::optiont::PARAMETER;
+      option.parameter_number = i;
+    }
+    else if (
+        i < parameter_types.size() &&
+        (word_type.id() == ID_unsignedbv ||
+         word_type.id() == ID_signedbv ||
+         word_type.id() == ID_integer))
+    {
+      // one read of the array, with a symbolic index
+      const std::string read_prefix = pc_prefix + "_a" + std::to_string(i);
+
+      auto &option = instruction.add_option(read_prefix + "sel");
+      option.kind = instructiont::optiont::BINARY;
+      option.operation = ID_index;
+      option.parameter_number = i;
+      option.index_constant = symbol_exprt(read_prefix + "_idx", word_type);
+
+      // the index is an earlier result, an argument or a literal
+      for (std::size_t operand = 0;
+           operand < pc + parameter_types.size() + literals.size();
+           operand++)
       {
-        for (std::size_t index = 0; index < ARRAY_MAX; index++)
-        {
-          irep_idt param_sel_id = id2string(identifier) + "_" +
-                                  std::to_string(pc) + "_p" + std::to_string(index) +
-                                  " " + std::to_string(i) +
-                                  "sel";
+        if (operand >= pc && operand - pc < parameter_types.size() &&
+            parameter_types[operand - pc].id() == ID_array)
+          continue;
 
-          auto &option = instruction.add_option(param_sel_id);
-          option.kind = instructiont::optiont::BINARY;
-          option.operation = ID_index;
-          option.parameter_number = i;
-          option.operand1 = index;
-        }
-        // irep_idt param_sel_id = id2string(identifier) + "_" +
-        //                         std::to_string(pc) + "_p" + std::to_string(i) +
-        //                         "sel";
-
-        // std::cout << "Adding array parameter " << i << " to instruction " << pc
-        //           << " with " << id2string(param_sel_id) << std::endl;
-        // auto &option = array_instruction.add_option(param_sel_id);
-        // option.kind = instructiont::optiont::ARRAY_PARAMETER;
-        // option.parameter_number = i;
+        option.index_options.emplace_back(
+            symbol_exprt(
+                read_prefix + "_x" + std::to_string(operand) + "sel",
+                bool_typet()),
+            operand);
       }
     }
+  }
 
-    // we only need array instructions for each parameter that is an array
-    // We do not support operators that can be applied to arrays and produce
-    // arrays as output.
-    // if ((pc >= arguments.size() ||
-    //      has_array_operand == 0) &&
-    //     array_instructions.size() != 0)
-    // {
-    //   array_instructions.pop_back();
-    // }
+  // we only need array instructions for each parameter that is an array
+  // We do not support operators that can be applied to arrays and produce
+  // arrays as output.
+  // if ((pc >= parameter_types.size() ||
+  //      has_array_operand == 0) &&
+  //     array_instructions.size() != 0)
+  // {
+  //   array_instructions.pop_back();
+  // }
 
-    // a binary operation
+  // a binary operation
 
-    static const irep_idt ops[] =
-        {ID_plus}; //, ID_minus, ID_shl,
-                   //  ID_le, ID_lt, ID_equal, ID_notequal, "max", "min", ID_index};
-    // static const irep_idt ops[] =
-    //     {ID_bitand, ID_bitor,
-    //      ID_le, ID_lt, ID_equal, ID_notequal};
+  std::size_t binary_option_index = 0;
 
-    std::size_t binary_option_index = 0;
+  for (const auto &operation : binary_operations(
+           word_type,
+           enable_bitwise,
+           enable_division,
+           has_array_operand > 0,
+           operator_budget))
+  {
+    for (std::size_t operand0 = 0; operand0 < pc; operand0++)
+      for (std::size_t operand1 = 0; operand1 < pc; operand1++)
+      {
+        // there is usually no point applying an operation to two
+        // identical operands, with the exception of ID_plus, which
+        // produces 2*x
 
-    for (const auto operation : ops)
-    {
-      if (!enable_bitwise || word_type.id() == ID_integer)
-        if (operation == ID_lshr ||
-            operation == ID_shl ||
-            operation == ID_bitand ||
-            operation == ID_bitor ||
-            operation == ID_bitxor)
+        if (operand0 == operand1 && (operation != ID_plus && operation != ID_index))
           continue;
 
-      if ((word_type.id() != ID_unsignedbv &&
-           word_type.id() != ID_signedbv) ||
-          !enable_division)
-        if (operation == ID_div)
+        // many operators are commutative, no need
+        // to have both orderings
+        if (is_commutative(operation))
+        {
+          if (operand0 > operand1)
+            continue;
+        }
+
+        // array operators can only be applied to arrays
+        // and only indexed with constants or parameters
+        // and only compared to constants or parameters
+        if ((operation == ID_index) &&
+            (operand0 >= array_instructions.size() ||
+             operand1 >= (parameter_types.size() + literals.size())))
           continue;
-      if (operation == ID_index && has_array_operand == 0)
-        continue;
 
-      for (std::size_t operand0 = 0; operand0 < pc; operand0++)
-        for (std::size_t operand1 = 0; operand1 < pc; operand1++)
-        {
-          // there is usually no point applying an operation to two
-          // identical operands, with the exception of ID_plus, which
-          // produces 2*x
+        irep_idt sel_id = pc_prefix + "_b" +
+                          std::to_string(binary_option_index) + "sel";
 
-          if (operand0 == operand1 && (operation != ID_plus && operation != ID_index))
-            continue;
+        auto &option = instruction.add_option(sel_id);
+        option.operand0 = operand0;
+        option.operand1 = operand1;
+        option.operation = operation;
 
-          // many operators are commutative, no need
-          // to have both orderings
-          if (operation == ID_plus ||
-              operation == ID_bitand ||
-              operation == ID_bitor ||
-              operation == ID_bitxor ||
-              operation == ID_equal ||
-              operation == ID_notequal ||
-              operation == "max" ||
-              operation == "min")
-          {
-            if (operand0 > operand1)
-              continue;
-          }
+        if (is_predicate(operation))
+          option.kind = instructiont::optiont::BINARY_PREDICATE;
+        else
+          option.kind = instructiont::optiont::BINARY;
 
-          // array operators can only be applied to arrays
-          // and only indexed with constants or parameters
-          // and only compared to constants or parameters
-          if ((operation == ID_index) &&
-              (operand0 >= array_instructions.size() ||
-               operand1 >= (arguments.size() + literals.size())))
-            continue;
+        binary_option_index++;
+      }
+  }
 
-          irep_idt final_operation = operation;
+  // a unary operation
 
-          if (word_type.id() == ID_bool)
-          {
-            if (operation == ID_plus ||
-                operation == ID_minus ||
-                operation == ID_lshr ||
-                operation == ID_shl ||
-                operation == ID_lt ||
-                operation == ID_le ||
-                operation == ID_notequal || // we got bitxor
-                operation == ID_index ||
-                operation == "max" ||
-                operation == "min" ||
-                operation == ID_div)
-              continue;
-
-            if (operation == ID_bitand)
-              final_operation = ID_and;
-            else if (operation == ID_bitor)
-              final_operation = ID_or;
-            else if (operation == ID_bitxor)
-              final_operation = ID_xor;
-          }
+  std::size_t unary_option_index = 0;
 
-          irep_idt sel_id = id2string(identifier) + "_" +
-                            std::to_string(pc) + "_b" +
-                            std::to_string(binary_option_index) + "sel";
+  for (const auto &operation :
+       unary_operations(word_type, enable_bitwise, operator_budget))
+  {
+    for (std::size_t operand0 = 0; operand0 < pc; operand0++)
+    {
+      irep_idt sel_id = pc_prefix + "_u" +
+                        std::to_string(unary_option_index) + "sel";
 
-          auto &option = instruction.add_option(sel_id);
-          option.operand0 = operand0;
-          option.operand1 = operand1;
-          option.operation = final_operation;
+      auto &option = instruction.add_option(sel_id);
+      option.operand0 = operand0;
+      option.operation = operation;
+      option.kind = instructiont::optiont::UNARY;
 
-          if (final_operation == ID_le ||
-              final_operation == ID_lt ||
-              final_operation == ID_equal ||
-              final_operation == ID_notequal)
-            option.kind = instructiont::optiont::BINARY_PREDICATE;
-          else
-            option.kind = instructiont::optiont::BINARY;
+      unary_option_index++;
+    }
+  }
 
-          binary_option_index++;
-        }
+  // trinary operator, if-then-else
+  if (operator_cost(ID_if) > operator_budget)
+    return;
+
+  std::size_t ternary_option_index = 0;
+
+  for (std::size_t operand0 = 0; operand0 < pc; operand0++)
+  {
+    // the condition must be able to compute a predicate,
+    // which is enforced by add_structure_constraints()
+    const auto &options = instructions[operand0].options;
+    if (word_type.id() != ID_bool &&
+        std::none_of(
+            options.begin(),
+            options.end(),
+            [](const instructiont::optiont &o) {
+              return o.kind == instructiont::optiont::BINARY_PREDICATE;
+            }))
+    {
+      continue;
     }
 
-    // std::size_t ternary_option_index = 0;
-    // // trinary operator, if-then-else
-    // for (std::size_t operand0 = 0; operand0 < pc; operand0++)
-    //   for (std::size_t operand1 = 0; operand1 < pc; operand1++)
-    //     for (std::size_t operand2 = 0; operand2 < pc; operand2++)
-    //     {
-    //       // no point using if-then-else if operand 1 and operand 2
-    //       // are the same
-    //       if (operand1 == operand2)
-    //         continue;
+    for (std::size_t operand1 = 0; operand1 < pc; operand1++)
+      for (std::size_t operand2 = 0; operand2 < pc; operand2++)
+      {
+        // no point using if-then-else if operand 1 and operand 2
+        // are the same
+        if (operand1 == operand2)
+          continue;
 
-    //       if (operand0 == operand1 || operand0 == operand2)
-    //         continue;
+        if (operand0 == operand1 || operand0 == operand2)
+          continue;
 
-    //       irep_idt sel_id = id2string(identifier) + "_" +
-    //                         std::to_string(pc) + "_t" +
-    //                         std::to_string(ternary_option_index) + "ite_sel";
+        irep_idt sel_id = pc_prefix + "_t" +
+                          std::to_string(ternary_option_index) + "ite_sel";
 
-    //       auto &option = instruction.add_option(sel_id);
-    //       option.operand0 = operand0;
-    //       option.operand1 = operand1;
-    //       option.operand2 = operand2;
-    //       option.operation = ID_if;
-    //       option.kind = instructiont::optiont::ITE;
+        auto &option = instruction.add_option(sel_id);
+        option.operand0 = operand0;
+        option.operand1 = operand1;
+        option.operand2 = operand2;
+        option.operation = ID_if;
+        option.kind = instructiont::optiont::ITE;
 
-    //       ternary_option_index++;
-    //     }
+        ternary_option_index++;
+      }
   }
 }
 
@@ -376,16 +566,25 @@ exprt e_datat::instructiont::constraint(
 
     case optiont::UNARY:
     {
-      break;
+      assert(option.operand0 < results.size());
+
+      result_expr = chain(
+          option.sel,
+          unary_operation(
+              option.operation, results[option.operand0], word_type),
+          result_expr);
     }
+    break;
+
     case optiont::BINARY: // a binary operation
     {
       if (option.operation == ID_index)
       {
         const auto &op0 = arguments[option.parameter_number];
-        // index array op0 with index op1
-        index_exprt tmp = index_exprt(op0, constant_exprt(std::to_string(option.operand1), word_type));
-        result_expr = chain(option.sel, tmp, result_expr);
+        // index array op0 with the chosen index
+        index_exprt tmp(
+            op0, index_operand(option, word_type, arguments, results));
+        result_expr = chain(option.sel, promotion(tmp, word_type), result_expr);
       }
       else
       {
@@ -404,21 +603,21 @@ exprt e_datat::instructiont::constraint(
           if_exprt if_expr(rel, op0, op1);
           result_expr = chain(option.sel, if_expr, result_expr);
         }
-        else if (option.operation == "ID_div")
+        else if (option.operation == ID_div)
         {
           // if op1 is zero, smt division returns 1111
-          equal_exprt op_divbyzero(op1, constant_exprt("0", op1.type()));
+          equal_exprt op_divbyzero(op1, from_integer(0, op1.type()));
 
           binary_exprt binary_expr(option.operation, word_type);
           binary_expr.op0() = op0;
           binary_expr.op1() = op1;
 
           bv_spect spec(op0.type());
-          if_exprt if_expr(op_divbyzero, constant_exprt(integer2string(spec.max_value()), op0.type()),
+          if_exprt if_expr(op_divbyzero, from_integer(spec.max_value(), op0.type()),
                            binary_expr);
           result_expr = chain(option.sel, if_expr, result_expr);
         }
-        else if (option.operation == "ID_lshr")
+        else if (option.operation == ID_lshr)
         {
           // shift operator
           lshr_exprt shift_expr(op0, op1);
@@ -426,14 +625,12 @@ exprt e_datat::instructiont::constraint(
 
           binary_predicate_exprt shift_greater_than_width(ID_ge);
           shift_greater_than_width.op0() = op1;
-          shift_greater_than_width.op1() = constant_exprt(
-              integer2string(to_unsignedbv_type(
-                                 op0.type())
-                                 .get_width()),
+          shift_greater_than_width.op1() = from_integer(
+              to_bitvector_type(op0.type()).get_width(),
               op0.type());
 
           if_exprt if_expr(shift_greater_than_width,
-                           constant_exprt("0", op0.type()), shift_expr);
+                           from_integer(0, op0.type()), shift_expr);
           result_expr = chain(option.sel, if_expr, result_expr);
         }
         else
@@ -493,68 +690,377 @@ exprt e_datat::instructiont::constraint(
   return result_expr;
 }
 
+exprt e_datat::instructiont::index_operand(
+    const optiont &option,
+    const typet &word_type,
+    const std::vector<exprt> &arguments,
+    const std::vector<exprt> &results) const
+{
+  exprt index = option.index_constant;
+
+  for (const auto &index_option : option.index_options)
+  {
+    const std::size_t operand = index_option.second;
+
+    const exprt candidate =
+        operand < pc
+            ? results[operand]
+            : promotion(arguments[operand - pc], word_type);
+
+    index = if_exprt(index_option.first, candidate, index);
+  }
+
+  return index;
+}
+
+symbol_exprt program_size_selector(std::size_t program_size)
+{
+  return symbol_exprt(
+      "synth::program_size" + std::to_string(program_size), bool_typet());
+}
+
+symbol_exprt e_datat::result_symbol(std::size_t instance, std::size_t pc) const
+{
+  return symbol_exprt(
+      id2string(function_symbol.get_identifier()) + "_inst" +
+          std::to_string(instance) + "_result_" + std::to_string(pc),
+      word_type);
+}
+
 std::size_t e_datat::instance_number(const argumentst &arguments)
 {
-  const auto res = instances.insert(
-      std::pair<argumentst, std::size_t>(arguments, instances.size()));
+  const auto res = instances.emplace(arguments, instances.size());
+
+  if (res.second)
+  {
+    // intern the names of the results of the new instance
+    const std::size_t instance = res.first->second;
+    const std::string prefix =
+        id2string(function_symbol.get_identifier()) + "_inst" +
+        std::to_string(instance);
+
+    instance_results.emplace_back();
+    auto &results = instance_results.back();
+    results.reserve(instructions.size());
+
+    instance_arguments.push_back(arguments);
+    copy(
+        begin(literals),
+        end(literals),
+        back_inserter(instance_arguments.back()));
+
+    for (std::size_t pc = 0; pc < instructions.size(); pc++)
+      results.push_back(instance_result(instance, pc));
+
+    instance_array_results.emplace_back();
+    auto &array_results = instance_array_results.back();
+    array_results.reserve(array_instructions.size());
+
+    for (std::size_t pc = 0; pc < array_instructions.size(); pc++)
+      array_results.push_back(symbol_exprt(
+          prefix + "_array_result_" + std::to_string(pc),
+          array_typet(word_type, infinity_exprt(word_type))));
+
+    instance_outputs.push_back(symbol_exprt(prefix + "_out", word_type));
+  }
 
   return res.first->second;
 }
 
-exprt e_datat::result(const argumentst &arguments)
+bool e_datat::use_definitions() const
 {
-  // find out which instance this is
-  std::size_t instance_number = this->instance_number(arguments);
-
-  std::vector<exprt> results, array_results;
-  results.resize(instructions.size(), nil_exprt());
-  array_results.resize(array_instructions.size(), nil_exprt());
+  return definitions != nullptr && has_array_operand == 0;
+}
 
-  constraints.clear();
+symbol_exprt e_datat::program_function(std::size_t pc) const
+{
+  return symbol_exprt(
+      id2string(function_symbol.get_identifier()) + "_program_" +
+          std::to_string(pc),
+      mathematical_function_typet(parameter_types, word_type));
+}
 
-  const irep_idt &identifier = function_symbol.get_identifier();
+void e_datat::define_instruction(std::size_t pc)
+{
+  const argumentst parameter_arguments(parameters.begin(), parameters.end());
 
-  argumentst args_with_consts(arguments);
+  argumentst args_with_consts = parameter_arguments;
   copy(begin(literals), end(literals), back_inserter(args_with_consts));
 
-  // build results
-  for (std::size_t pc = 0; pc < instructions.size(); pc++)
+  // the earlier instructions are applied to the same parameters
+  std::vector<exprt> results;
+  results.reserve(pc);
+  for (std::size_t i = 0; i < pc; i++)
+    results.push_back(function_application_exprt(
+        program_function(i), parameter_arguments, word_type));
+
+  definitions->define_function(
+      program_function(pc),
+      parameters,
+      instructions[pc].constraint(word_type, args_with_consts, results, {}));
+}
+
+exprt e_datat::instance_result(std::size_t instance, std::size_t pc) const
+{
+  if (!use_definitions())
+    return result_symbol(instance, pc);
+
+  // the arguments without the literals
+  const argumentst &args_with_consts = instance_arguments[instance];
+  const argumentst arguments(
+      args_with_consts.begin(),
+      args_with_consts.begin() + parameter_types.size());
+
+  return function_application_exprt(program_function(pc), arguments, word_type);
+}
+
+exprt e_datat::output(std::size_t instance) const
+{
+  if (link_outputs)
+    return promotion(instance_outputs[instance], return_type);
+  else
+    return promotion(instance_results[instance].back(), return_type);
+}
+
+void e_datat::link_output(std::size_t instance)
+{
+  constraints.push_back(implies_exprt(
+      program_size_selector(instructions.size()),
+      equal_exprt(
+          instance_outputs[instance], instance_results[instance].back())));
+}
+
+bool e_datat::use_clauses() const
+{
+  return clauses != nullptr &&
+         word_type.id() == ID_bool &&
+         has_array_operand == 0;
+}
+
+void e_datat::instruction_clauses(std::size_t instance, std::size_t pc)
+{
+  bool_encodingt &bool_encoding = *clauses;
+  const argumentst &arguments = instance_arguments[instance];
+  const std::vector<exprt> &results = instance_results[instance];
+  const instructiont &instruction = instructions[pc];
+
+  std::vector<literalt> operands;
+  operands.reserve(pc);
+  for (std::size_t i = 0; i < pc; i++)
+    operands.push_back(bool_encoding.convert(results[i]));
+
+  // follows instructiont::constraint(), the constant is the last resort
+  literalt value = bool_encoding.convert(instruction.constant_val);
+
+  for (const auto &option : instruction.options)
   {
-    // results vary by instance
-    irep_idt result_identifier = id2string(identifier) + "_inst" +
-                                 std::to_string(instance_number) + "_result_" +
-                                 std::to_string(pc);
+    literalt option_value;
+
+    switch (option.kind)
+    {
+    case instructiont::optiont::PARAMETER:
+      option_value = bool_encoding.convert(
+          promotion(arguments[option.parameter_number], word_type));
+      break;
 
-    results[pc] = symbol_exprt(result_identifier, word_type);
+    case instructiont::optiont::UNARY:
+      INVARIANT(option.operation == ID_not, "Boolean unary operation");
+      option_value = !operands[option.operand0];
+      break;
 
-    if (pc < array_instructions.size())
+    case instructiont::optiont::BINARY:
+    case instructiont::optiont::BINARY_PREDICATE:
     {
-      irep_idt array_result_identifier =
-          id2string(identifier) + "_inst" + std::to_string(instance_number) +
-          "_array_result_" + std::to_string(pc);
+      const literalt op0 = operands[option.operand0];
+      const literalt op1 = operands[option.operand1];
+
+      if (option.operation == ID_and)
+        option_value = bool_encoding.land(op0, op1);
+      else if (option.operation == ID_or)
+        option_value = bool_encoding.lor(op0, op1);
+      else if (option.operation == ID_xor)
+        option_value = bool_encoding.lxor(op0, op1);
+      else if (option.operation == ID_equal)
+        option_value = !bool_encoding.lxor(op0, op1);
+      else
+        UNREACHABLE;
+    }
+    break;
 
-      array_results[pc] = symbol_exprt(array_result_identifier,
-                                       array_typet(word_type,
-                                                   infinity_exprt(word_type)));
+    case instructiont::optiont::ITE:
+      option_value = bool_encoding.lselect(
+          operands[option.operand0],
+          operands[option.operand1],
+          operands[option.operand2]);
+      break;
+
+    case instructiont::optiont::ARRAY_PARAMETER:
+    case instructiont::optiont::NONE:
+      UNREACHABLE;
     }
-    assert(!results.empty());
+
+    value = bool_encoding.lselect(
+        bool_encoding.convert(option.sel), option_value, value);
   }
 
+  bool_encoding.set_equal(bool_encoding.convert(results[pc]), value);
+}
+
+void e_datat::instruction_constraints(std::size_t instance, std::size_t pc)
+{
+  // the result is an application of the definition
+  if (use_definitions())
+    return;
+
+  if (use_clauses())
+  {
+    instruction_clauses(instance, pc);
+    return;
+  }
+
+  const argumentst &args_with_consts = instance_arguments[instance];
+  const std::vector<exprt> &results = instance_results[instance];
+  const std::vector<exprt> &array_results = instance_array_results[instance];
+
+  exprt c = instructions[pc].constraint(
+      word_type, args_with_consts, results, array_results);
+  constraints.push_back(equal_exprt(results[pc], c));
+
+  // array reads stay within array_size
+  for (const auto &option : instructions[pc].options)
+    if (option.operation == ID_index)
+    {
+      const exprt index = instructions[pc].index_operand(
+          option, word_type, args_with_consts, results);
+
+      exprt::operandst bounds;
+      bounds.push_back(binary_relation_exprt(
+          index, ID_lt, from_integer(array_size, word_type)));
+
+      if (word_type.id() != ID_unsignedbv)
+        bounds.push_back(binary_relation_exprt(
+            index, ID_ge, from_integer(0, word_type)));
+
+      constraints.push_back(implies_exprt(option.sel, conjunction(bounds)));
+    }
+
+  if (pc < array_instructions.size())
+  {
+    exprt c_array = array_instructions[pc].constraint(
+        word_type, args_with_consts, results, array_results);
+    constraints.push_back(equal_exprt(array_results[pc], c_array));
+  }
+}
+
+exprt e_datat::result(const argumentst &arguments)
+{
+  // find out which instance this is
+  const std::size_t known_instances = instances.size();
+  std::size_t instance_number = this->instance_number(arguments);
+
+  assert(!instance_results[instance_number].empty());
+
+  // an instance seen before has already been constrained
+  if (instances.size() == known_instances)
+    return output(instance_number);
+
+  // the selectors are shared by all instances
+  if (instance_number == 0)
+    for (std::size_t pc = 0; pc < instructions.size(); pc++)
+      add_structure_constraints(pc);
+
   // build constraints
   for (std::size_t pc = 0; pc < instructions.size(); pc++)
+    instruction_constraints(instance_number, pc);
+
+  if (link_outputs)
+    link_output(instance_number);
+
+  return output(instance_number);
+}
+
+void e_datat::grow(std::size_t program_size)
+{
+  const std::size_t old_size = instructions.size();
+
+  if (program_size <= old_size)
+    return;
+
+  while (instructions.size() < program_size)
   {
-    exprt c = instructions[pc].constraint(
-        word_type, args_with_consts, results, array_results);
-    constraints.push_back(equal_exprt(results[pc], c));
+    add_instruction();
 
-    if (pc < array_instructions.size())
+    if (use_definitions())
+      define_instruction(instructions.size() - 1);
+  }
+
+  for (std::size_t instance = 0; instance < instances.size(); instance++)
+    for (std::size_t pc = old_size; pc < program_size; pc++)
+      instance_results[instance].push_back(instance_result(instance, pc));
+
+  // without instances, result() adds these for all instructions
+  if (!instances.empty())
+    for (std::size_t pc = old_size; pc < program_size; pc++)
+      add_structure_constraints(pc);
+
+  // the instructions below old_size are constrained already
+  for (std::size_t instance = 0; instance < instances.size(); instance++)
+  {
+    for (std::size_t pc = old_size; pc < program_size; pc++)
+      instruction_constraints(instance, pc);
+
+    if (link_outputs)
+      link_output(instance);
+  }
+}
+
+exprt e_datat::selects(
+    std::size_t pc,
+    const std::function<bool(const instructiont::optiont &)> &kind) const
+{
+  // the constant is the default, later options take precedence
+  exprt result = false_exprt();
+
+  for (const auto &option : instructions[pc].options)
+  {
+    if (kind(option))
+      result = or_exprt(option.sel, result);
+    else
+      result = and_exprt(not_exprt(option.sel), result);
+  }
+
+  return result;
+}
+
+void e_datat::add_structure_constraints(std::size_t pc)
+{
+  for (const auto &option : instructions[pc].options)
+  {
+    if (option.kind == instructiont::optiont::ITE &&
+        word_type.id() != ID_bool)
     {
-      exprt c_array = array_instructions[pc].constraint(
-          word_type, args_with_consts, results, array_results);
-      constraints.push_back(equal_exprt(array_results[pc], c_array));
+      const exprt condition_is_predicate = selects(
+          option.operand0, [](const instructiont::optiont &o) {
+            return o.kind == instructiont::optiont::BINARY_PREDICATE;
+          });
+
+      constraints.push_back(
+          implies_exprt(option.sel, condition_is_predicate));
+    }
+    else if (option.kind == instructiont::optiont::UNARY)
+    {
+      // all unary operations are involutions
+      const irep_idt operation = option.operation;
+
+      const exprt is_same = selects(
+          option.operand0, [&operation](const instructiont::optiont &o) {
+            return o.kind == instructiont::optiont::UNARY &&
+                   o.operation == operation;
+          });
+
+      constraints.push_back(implies_exprt(option.sel, not_exprt(is_same)));
     }
   }
-  return promotion(results.back(), return_type);
 }
 
 exprt e_datat::get_function(
@@ -674,7 +1180,10 @@ exprt e_datat::get_function(
         break;
 
         case instructiont::optiont::UNARY:
-          // TBD
+          assert(o_it->operand0 < results.size());
+
+          result = unary_operation(
+              o_it->operation, results[o_it->operand0], word_type);
           break;
 
         case instructiont::optiont::BINARY:
@@ -682,40 +1191,52 @@ exprt e_datat::get_function(
           const auto &binary_op = *o_it;
           if (binary_op.operation == ID_index)
           {
-            assert(binary_op.operand1 < ARRAY_MAX);
             irep_idt p_identifier = "synth::parameter" +
                                     std::to_string(binary_op.parameter_number);
             exprt op0 = symbol_exprt(p_identifier,
                                      parameter_types[binary_op.parameter_number]);
-            exprt op1 = constant_exprt(std::to_string(binary_op.operand1), word_type);
-            result = index_exprt(op0, op1);
+
+            // the last selected index operand wins
+            exprt op1 = nil_exprt();
+
+            for (auto i_it = binary_op.index_options.rbegin();
+                 op1.is_nil() && i_it != binary_op.index_options.rend();
+                 i_it++)
+            {
+              if (!solver.get(i_it->first).is_true())
+                continue;
+
+              const std::size_t operand = i_it->second;
+              const std::size_t num_params = parameter_types.size();
+
+              if (operand < pc)
+                op1 = results[operand];
+              else if (operand - pc < num_params)
+                op1 = promotion(
+                    symbol_exprt(
+                        "synth::parameter" + std::to_string(operand - pc),
+                        parameter_types[operand - pc]),
+                    word_type);
+              else
+                op1 = *next(begin(literals), operand - pc - num_params);
+            }
+
+            if (op1.is_nil())
+              op1 = constant_variables ? exprt(binary_op.index_constant)
+                                       : solver.get(binary_op.index_constant);
+
+            result = promotion(index_exprt(op0, op1), word_type);
           }
           else
           {
             assert(binary_op.operand0 < results.size());
             assert(binary_op.operand1 < results.size());
 
-            exprt op0 = results[binary_op.operand0];
-            exprt op1 = results[binary_op.operand1];
-
-            if (binary_op.operation == "max")
-            {
-              binary_predicate_exprt rel(op0, ID_ge, op1);
-              result = if_exprt(rel, op0, op1);
-            }
-            else if (binary_op.operation == "min")
-            {
-              binary_predicate_exprt rel(op0, ID_le, op1);
-              result = if_exprt(rel, op0, op1);
-            }
-            else
-            {
-              result = binary_exprt(
-                  op0,
-                  binary_op.operation,
-                  op1,
-                  word_type);
-            }
+            result = binary_operation(
+                binary_op.operation,
+                results[binary_op.operand0],
+                results[binary_op.operand1],
+                word_type);
           }
         }
         break;
@@ -727,13 +1248,11 @@ exprt e_datat::get_function(
           assert(binary_op.operand0 < results.size());
           assert(binary_op.operand1 < results.size());
 
-          result = binary_exprt(
-              results[binary_op.operand0],
+          result = binary_operation(
               binary_op.operation,
+              results[binary_op.operand0],
               results[binary_op.operand1],
-              bool_typet());
-
-          result = promotion(result, word_type);
+              word_type);
         }
         break;
 
@@ -791,25 +1310,7 @@ exprt synth_encodingt::operator()(const exprt &expr)
       op = (*this)(op);
     }
 
-    DATA_INVARIANT(tmp.function().id() == ID_symbol, "function must be symbol");
-    e_datat &e_data = e_data_map[to_symbol_expr(tmp.function())];
-    // TOOD: move this into constructor?
-    e_data.array_size = array_size;
-    if (e_data.word_type.id().empty())
-      e_data.literals = literals;
-    exprt final_result = e_data(
-        tmp,
-        program_size,
-        enable_bitwise,
-        enable_division);
-
-    for (const auto &c : e_data.constraints)
-    {
-      // std::cout<<"Push back e_data_constraint "<< c.pretty()<<std::endl;
-      constraints.push_back(c);
-    }
-
-    return final_result;
+    return function_application(tmp);
   }
   else if (expr.id() == ID_symbol)
   { // std::cout<<"adding suffix to symbol "<< expr.pretty()<<std::endl;
@@ -837,6 +1338,56 @@ exprt synth_encodingt::operator()(const exprt &expr)
   }
 }
 
+exprt synth_encodingt::function_application(
+    const function_application_exprt &expr)
+{
+  DATA_INVARIANT(expr.function().id() == ID_symbol, "function must be symbol");
+  e_datat &e_data = e_data_map[to_symbol_expr(expr.function())];
+  // TOOD: move this into constructor?
+  e_data.array_size = array_size;
+  e_data.operator_budget = operator_budget;
+  if (e_data.word_type.id().empty())
+  {
+    e_data.literals = literals;
+    e_data.link_outputs = growable;
+    e_data.distinct_integer_constants = distinct_integer_constants;
+    e_data.clauses = clauses;
+    e_data.definitions = definitions;
+  }
+  exprt final_result = e_data(
+      expr,
+      program_size,
+      enable_bitwise,
+      enable_division);
+
+  for (const auto &c : e_data.constraints)
+  {
+    // std::cout<<"Push back e_data_constraint "<< c.pretty()<<std::endl;
+    constraints.push_back(c);
+  }
+
+  return final_result;
+}
+
+bool synth_encodingt::grow(std::size_t new_program_size)
+{
+  if (!growable)
+    return false;
+
+  program_size = new_program_size;
+
+  for (auto &it : e_data_map)
+  {
+    it.second.constraints.clear();
+    it.second.grow(program_size);
+
+    for (const auto &c : it.second.constraints)
+      constraints.push_back(c);
+  }
+
+  return true;
+}
+
 solutiont synth_encodingt::get_solution(
     const decision_proceduret &solver) const
 {
@@ -854,6 +1405,30 @@ solutiont synth_encodingt::get_solution(
   return result;
 }
 
+std::vector<symbol_exprt> synth_encodingt::program_variables() const
+{
+  std::vector<symbol_exprt> result;
+
+  for (const auto &it : e_data_map)
+    for (const auto &instruction : it.second.instructions)
+    {
+      result.push_back(instruction.constant_val);
+
+      for (const auto &option : instruction.options)
+      {
+        result.push_back(option.sel);
+
+        for (const auto &index_option : option.index_options)
+          result.push_back(index_option.first);
+
+        if (!option.index_constant.get_identifier().empty())
+          result.push_back(option.index_constant);
+      }
+    }
+
+  return result;
+}
+
 /*void synth_encodingt::clear()
 {
   e_data_map.clear();
@@ -1,13 +1,78 @@
 #ifndef CPROVER_FASTSYNTH_SYNTH_ENCODING_H_
 #define CPROVER_FASTSYNTH_SYNTH_ENCODING_H_
 
+#include <util/irep_hash.h>
 #include <util/mathematical_expr.h>
 
 #include <solvers/decision_procedure.h>
 
 #include "cegis_types.h"
 
+class bool_encodingt;
+class smt2_sessiont;
+
+#include <functional>
 #include <set>
+#include <unordered_map>
+
+typet promotion(const typet &, const typet &);
+exprt promotion(const exprt &, const typet &);
+
+/// Cost of an operator. Learners only use operators whose cost is
+/// within their operator budget.
+std::size_t operator_cost(const irep_idt &operation);
+
+/// Binary operations the learners may choose from for the given word
+/// type. Boolean words use the logical counterparts of the bitwise
+/// operators.
+std::vector<irep_idt> binary_operations(
+    const typet &word_type,
+    bool enable_bitwise,
+    bool enable_division,
+    bool has_array_operand,
+    std::size_t operator_budget);
+
+/// Unary operations the learners may choose from for the given word
+/// type: negation, and the bitwise complement (logical not for Boolean
+/// words).
+std::vector<irep_idt> unary_operations(
+    const typet &word_type,
+    bool enable_bitwise,
+    std::size_t operator_budget);
+
+bool is_commutative(const irep_idt &operation);
+bool is_predicate(const irep_idt &operation);
+
+/// Applies a unary operation chosen by a learner.
+exprt unary_operation(
+    const irep_idt &operation,
+    const exprt &op,
+    const typet &word_type);
+
+/// Applies a binary operation chosen by a learner.
+/// Predicates are promoted to the word type.
+exprt binary_operation(
+    const irep_idt &operation,
+    const exprt &op0,
+    const exprt &op1,
+    const typet &word_type);
+
+/// Holds if the program size is the given one; used by encodings that
+/// can grow, see e_datat::link_outputs.
+symbol_exprt program_size_selector(std::size_t program_size);
+
+/// Hashes the argument vector of a function application.
+struct argumentst_hash
+{
+  std::size_t operator()(
+      const function_application_exprt::argumentst &arguments) const
+  {
+    std::size_t result = arguments.size();
+    for (const auto &a : arguments)
+      result = hash_combine(result, a.hash());
+    return result;
+  }
+};
 
 struct e_datat
 {
@@ -16,6 +81,11 @@ public:
               enable_division(false),
               has_array_operand(0u),
               array_size(10u),
+              operator_budget(1u),
+              link_outputs(false),
+              distinct_integer_constants(false),
+              clauses(nullptr),
+              definitions(nullptr),
               setup_done(false) {}
 
   exprt operator()(
@@ -24,6 +94,7 @@ public:
       bool enable_bitwise,
       bool enable_division)
   {
+    constraints.clear();
     setup(expr, program_size, enable_bitwise);
     return result(expr.arguments());
   }
@@ -64,6 +135,12 @@ public:
       } kind;
       std::size_t operand0, operand1, operand2;
       exprt type;
+
+      /// Array reads: selectors for the index, each paired with an
+      /// earlier result (below pc) or an argument (pc and above, offset
+      /// by pc). If none is selected, index_constant is the index.
+      std::vector<std::pair<symbol_exprt, std::size_t>> index_options;
+      symbol_exprt index_constant = symbol_exprt::typeless(ID_empty_string);
     };
 
     using optionst = std::vector<optiont>;
@@ -86,6 +163,13 @@ public:
         const std::vector<exprt> &results,
         const std::vector<exprt> &array_results);
 
+    /// The index of an array read, as chosen by its index selectors.
+    exprt index_operand(
+        const optiont &,
+        const typet &word_type,
+        const std::vector<exprt> &arguments,
+        const std::vector<exprt> &results) const;
+
   protected:
     if_exprt chain(
         const symbol_exprt &selector,
@@ -113,29 +197,114 @@ public:
 
   typet compute_word_type();
 
+  using argumentst =
+      function_application_exprt::argumentst;
+
   using instancest =
-      std::map<function_application_exprt::argumentst, std::size_t>;
+      std::unordered_map<argumentst, std::size_t, argumentst_hash>;
   instancest instances;
 
-  using argumentst =
-      function_application_exprt::argumentst;
+  /// Interned results, indexed by instance number and pc: symbols, or
+  /// applications of program_function() if use_definitions() holds.
+  /// Built when an instance is first seen, and extended by grow().
+  std::vector<std::vector<exprt>> instance_results;
+  std::vector<std::vector<exprt>> instance_array_results;
+
+  /// Arguments of each instance, followed by the literals.
+  std::vector<argumentst> instance_arguments;
+
+  /// Output of each instance, if link_outputs is set.
+  std::vector<symbol_exprt> instance_outputs;
 
   std::size_t instance_number(const argumentst &);
 
+  /// Adds instructions up to the given program size. The constraints
+  /// for the new instructions of all instances are put into constraints.
+  void grow(std::size_t program_size);
+
   bool enable_bitwise;
   bool enable_division;
   std::size_t has_array_operand;
   std::size_t array_size;
   std::vector<bool> operand_is_array;
 
+  /// Operators with a higher operator_cost are not offered.
+  std::size_t operator_budget;
+
+  /// If set, the output of an instance is a symbol that equals the
+  /// result of the last instruction only when the
+  /// program_size_selector() of the current size holds, so that
+  /// instructions can be added without encoding the instances again.
+  bool link_outputs;
+
+  /// If set, each instruction on integers has a constant of its own;
+  /// otherwise all share the constant "0".
+  bool distinct_integer_constants;
+
+  /// If set, the instructions of Boolean functions are emitted as
+  /// clauses through this, instead of as constraints.
+  bool_encodingt *clauses;
+
+  /// If set, each instruction is sent to this solver once, as a
+  /// define-fun over the parameters, and the instances apply it to
+  /// their arguments instead of repeating its constraint.
+  smt2_sessiont *definitions;
+
   /// Pre-configured constants to include in the expression set.
   std::set<constant_exprt> literals;
 
 protected:
   bool setup_done;
 
+  /// Parameters of the functions defined by define_instruction().
+  std::vector<symbol_exprt> parameters;
+
+  /// Whether instructions are defined through definitions.
+  bool use_definitions() const;
+
+  /// The function computing the result of instruction \p pc.
+  symbol_exprt program_function(std::size_t pc) const;
+
+  /// Sends the definition of program_function(pc) to the solver.
+  void define_instruction(std::size_t pc);
+
+  /// The result of instruction \p pc for an instance.
+  exprt instance_result(std::size_t instance, std::size_t pc) const;
+
+  /// Whether instruction_clauses() is used.
+  bool use_clauses() const;
+
+  /// Emits the constraint of an instruction for an instance as clauses.
+  void instruction_clauses(std::size_t instance, std::size_t pc);
+
   exprt result(const argumentst &);
 
+  /// Appends an instruction with all its options.
+  void add_instruction();
+
+  symbol_exprt result_symbol(std::size_t instance, std::size_t pc) const;
+
+  /// The result of the function for an instance.
+  exprt output(std::size_t instance) const;
+
+  /// Links the output of an instance to the last instruction.
+  void link_output(std::size_t instance);
+
+  /// Constrains the result of an instruction for an instance.
+  void instruction_constraints(std::size_t instance, std::size_t pc);
+
+  /// Expression that holds if instruction \p pc selects an option of
+  /// the given kind, following the selection order of constraint().
+  exprt selects(
+      std::size_t pc,
+      const std::function<bool(const instructiont::optiont &)> &) const;
+
+  /// Constraints on the selectors of an instruction that rule out
+  /// redundant programs: the condition of an if-then-else is a
+  /// predicate, and a unary operation is not applied to the result of
+  /// the same operation.
+  void add_structure_constraints(std::size_t pc);
+
   void setup(
       const function_application_exprt &,
       const std::size_t program_size,
@@ -149,11 +318,23 @@ public:
       : program_size(1),
         enable_bitwise(false),
         enable_division(false),
-        array_size(10) {}
+        array_size(10),
+        operator_budget(1),
+        growable(false),
+        distinct_integer_constants(false),
+        clauses(nullptr),
+        definitions(nullptr) {}
+
+  virtual ~synth_encodingt() = default;
 
   exprt operator()(const exprt &);
 
-  solutiont get_solution(const decision_proceduret &) const;
+  virtual solutiont get_solution(const decision_proceduret &) const;
+
+  /// The selectors and constants of the functions encoded so far, whose
+  /// values in a model determine the solution. Their names only depend
+  /// on the function and the instruction.
+  virtual std::vector<symbol_exprt> program_variables() const;
 
   std::string suffix;
   std::size_t program_size;
@@ -161,6 +342,27 @@ public:
   bool enable_division;
   std::size_t array_size;
 
+  /// \see e_datat::operator_budget
+  std::size_t operator_budget;
+
+  /// \see e_datat::link_outputs
+  bool growable;
+
+  /// \see e_datat::distinct_integer_constants
+  bool distinct_integer_constants;
+
+  /// \see e_datat::clauses
+  bool_encodingt *clauses;
+
+  /// \see e_datat::definitions
+  smt2_sessiont *definitions;
+
+  /// Adds instructions up to the given program size to the functions
+  /// encoded so far, which requires growable. The constraints for the
+  /// new instructions are put into constraints.
+  /// \return False if the encoding cannot grow.
+  virtual bool grow(std::size_t program_size);
+
   using constraintst = std::list<exprt>;
   constraintst constraints;
 
@@ -169,6 +371,12 @@ public:
 
 protected:
   std::map<symbol_exprt, e_datat> e_data_map;
+
+  /// Encodes an application of a function to be synthesised.
+  /// The arguments are already encoded.
+  /// \param expr Function application to encode.
+  /// \return Expression for the result of the application.
+  virtual exprt function_application(const function_application_exprt &);
 };
 
 #endif /* CPROVER_FASTSYNTH_SYNTH_ENCODING_H_ */
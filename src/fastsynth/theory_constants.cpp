@@ -0,0 +1,162 @@
+#include "theory_constants.h"
+#include "fourier_motzkin.h"
+#include "solver.h"
+#include "synth_bv.h"
+#include "verify_encoding.h"
+
+#include <solvers/sat/satcheck.h>
+
+#include <langapi/language_util.h>
+
+#include <util/arith_tools.h>
+#include <util/replace_expr.h>
+
+/// Collects the symbols of a function body that are not parameters.
+static void get_constants(const exprt &src, std::set<symbol_exprt> &dest)
+{
+  static const std::string parameter_prefix = "synth::parameter";
+
+  for (auto it(src.depth_cbegin()); it != src.depth_cend(); ++it)
+  {
+    if (it->id() != ID_symbol)
+      continue;
+
+    const auto &symbol = to_symbol_expr(*it);
+    const std::string identifier = id2string(symbol.get_identifier());
+
+    if (std::string(identifier, 0, parameter_prefix.size()) != parameter_prefix)
+      dest.insert(symbol);
+  }
+}
+
+bool theory_constantst::set_template(const solutiont &solution)
+{
+  if (solution.s_functions != s_functions)
+  {
+    s_functions = solution.s_functions;
+    constants.clear();
+    constraints.clear();
+    projected = false;
+
+    for (const auto &f : s_functions)
+      get_constants(f.second, constants);
+  }
+
+  return !constants.empty();
+}
+
+exprt theory_constantst::instantiate(
+    const counterexamplet &counterexample) const
+{
+  verify_encodingt verify_encoding;
+  verify_encoding.functions = s_functions;
+  verify_encoding.free_variables = problem.free_variables;
+
+  exprt instance = implies_exprt(
+      conjunction(problem.side_conditions),
+      conjunction(problem.constraints));
+
+  instance = verify_encoding(instance);
+
+  replace_mapt assignment;
+
+  for (const auto &it : counterexample.assignment)
+    assignment[it.first] = it.second;
+
+  replace_expr(assignment, instance);
+
+  return instance;
+}
+
+exprt theory_constantst::project() const
+{
+  // the projection treats all arithmetic as unbounded
+  for (const auto &v : problem.free_variables)
+    if (v.type().id() != ID_integer)
+      return nil_exprt();
+
+  for (const auto &c : constants)
+    if (c.type().id() != ID_integer)
+      return nil_exprt();
+
+  verify_encodingt verify_encoding;
+  verify_encoding.functions = s_functions;
+  verify_encoding.free_variables = problem.free_variables;
+
+  satcheckt satcheck(get_message_handler());
+  fourier_motzkint fm(ns, satcheck, get_message_handler());
+  fm.existential_variables = problem.free_variables;
+
+  // the constants for which some assignment violates the problem
+  for (const auto &e : problem.side_conditions)
+    fm.set_to_true(verify_encoding(e));
+
+  fm.set_to_false(verify_encoding(conjunction(problem.constraints)));
+
+  if (fm() != decision_proceduret::resultt::D_UNSATISFIABLE)
+    return nil_exprt();
+
+  return not_exprt(fm.get_result());
+}
+
+void theory_constantst::add_ce(const counterexamplet &counterexample)
+{
+  constraints.push_back(instantiate(counterexample));
+
+  if (use_fm && !projected)
+  {
+    projected = true;
+
+    const exprt projection = project();
+
+    if (projection.is_not_nil())
+    {
+      debug() << "FM projection: " << from_expr(ns, "", projection) << eom;
+      constraints.push_back(projection);
+    }
+    else
+      debug() << "FM projection not applicable" << eom;
+  }
+}
+
+decision_proceduret::resultt theory_constantst::operator()(
+    solutiont &solution)
+{
+  solvert solver_container(
+      use_smt,
+      logic,
+      ns,
+      get_message_handler(),
+      has_pointer_type(problem),
+      sat_solver);
+  auto &solver = solver_container.get();
+
+  for (const auto &c : constraints)
+  {
+    debug() << "tc: " << from_expr(ns, "", c) << eom;
+    solver.set_to_true(c);
+  }
+
+  const decision_proceduret::resultt result = solver();
+
+  if (result != decision_proceduret::resultt::D_SATISFIABLE)
+    return result;
+
+  replace_mapt values;
+
+  for (const auto &c : constants)
+  {
+    const exprt value = solver.get(c);
+
+    // constants that no constraint mentions are unconstrained
+    values[c] = value.is_nil() ? from_integer(0, c.type()) : value;
+  }
+
+  solution.s_functions = s_functions;
+  solution.functions = s_functions;
+
+  for (auto &f : solution.functions)
+    replace_expr(values, f.second);
+
+  return result;
+}
@@ -0,0 +1,75 @@
+#ifndef CPROVER_FASTSYNTH_THEORY_CONSTANTS_H_
+#define CPROVER_FASTSYNTH_THEORY_CONSTANTS_H_
+
+#include "cegis_types.h"
+
+#include <solvers/decision_procedure.h>
+
+#include <util/message.h>
+#include <util/namespace.h>
+
+/// Theory back end for CEGIS(T): the learner fixes the structure of a
+/// candidate, given by solutiont::s_functions with symbolic constants,
+/// and the constants are found by a separate query over this template.
+/// Each counterexample yields a constraint on the constants.
+class theory_constantst:public messaget
+{
+public:
+  theory_constantst(
+    const namespacet &_ns,
+    const problemt &_problem,
+    message_handlert &_message_handler):
+    messaget(_message_handler),
+    use_fm(false),
+    use_smt(false),
+    ns(_ns), problem(_problem),
+    projected(false)
+  {
+  }
+
+  /// Sets the template to find constants for. The constraints collected
+  /// so far are kept if the template has not changed.
+  /// \return False if the template has no symbolic constants.
+  bool set_template(const solutiont &);
+
+  /// Adds the constraint on the constants given by a counterexample.
+  void add_ce(const counterexamplet &);
+
+  /// Finds constants that satisfy all constraints.
+  /// \param solution Receives the template with the constants
+  ///   filled in, as solutiont::functions.
+  /// \return \see decision_proceduret::resultt
+  decision_proceduret::resultt operator()(solutiont &);
+
+  /// Generalise the first counterexample for a template to the set of
+  /// all bad constants, by Fourier-Motzkin projection of the free
+  /// variables. Only used on integer problems.
+  bool use_fm;
+
+  bool use_smt;
+  std::string logic;
+
+  /// SAT back end, see new_sat_solver().
+  std::string sat_solver;
+
+protected:
+  const namespacet &ns;
+  const problemt &problem;
+
+  solutiont::functionst s_functions;
+  std::set<symbol_exprt> constants;
+
+  /// Constraints on the constants for the current template.
+  exprt::operandst constraints;
+  bool projected;
+
+  /// The problem, with the template substituted for the functions,
+  /// holds at the given assignment.
+  exprt instantiate(const counterexamplet &) const;
+
+  /// Constants for which the template holds for all assignments, or
+  /// nil if the projection is not applicable.
+  exprt project() const;
+};
+
+#endif /* CPROVER_FASTSYNTH_THEORY_CONSTANTS_H_ */
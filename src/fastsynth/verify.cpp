@@ -1,8 +1,14 @@
 #include "verify.h"
+#include "smt2_session.h"
 #include "solver.h"
+#include "synth_bv.h"
 
 #include <langapi/language_util.h>
 
+verifyt::~verifyt()
+{
+}
+
 void verifyt::output(
     const solutiont::functionst &functions,
     std::ostream &out)
@@ -32,9 +38,34 @@ decision_proceduret::resultt verifyt::operator()(
   // are consistent with the function signature
   verify_encodingt::check_function_bodies(solution.functions);
 
-  solvert solver_container(use_smt, logic, ns, get_message_handler());
-  auto &solver = solver_container.get();
+  if (use_smt)
+  {
+    if (!smt_process)
+      smt_process = std::unique_ptr<smt2_processt>(new smt2_processt());
+
+    // a fresh session per candidate, as the definitions of the
+    // candidate's symbols differ; the session resets the process and
+    // sends the whole problem again, as smt2_convt cannot forget what
+    // it declared in a popped scope
+    smt2_sessiont session(ns, logic, *smt_process, get_message_handler());
+    return solve(solution, session);
+  }
+
+  solvert solver_container(
+      use_smt,
+      logic,
+      ns,
+      get_message_handler(),
+      has_pointer_type(problem),
+      sat_solver);
+
+  return solve(solution, solver_container.get());
+}
 
+decision_proceduret::resultt verifyt::solve(
+    const solutiont &solution,
+    decision_proceduret &solver)
+{
   decision_proceduret::resultt result;
 
   verify_encodingt verify_encoding;
@@ -56,6 +87,14 @@ decision_proceduret::resultt verifyt::operator()(
 void verifyt::add_problem(
     verify_encodingt &verify_encoding,
     decision_proceduret &solver)
+{
+  add_problem(verify_encoding, solver, problem.constraints);
+}
+
+void verifyt::add_problem(
+    verify_encodingt &verify_encoding,
+    decision_proceduret &solver,
+    const exprt::operandst &constraints)
 {
   debug() << "ADDING VERIFICATION PROBLEM \n"
           << eom;
@@ -66,7 +105,7 @@ void verifyt::add_problem(
     solver.set_to_true(encoded);
   }
 
-  const exprt encoded = verify_encoding(conjunction(problem.constraints));
+  const exprt encoded = verify_encoding(conjunction(constraints));
   debug() << "co: !(" << from_expr(ns, "", encoded) << ')' << eom;
   solver.set_to_false(encoded);
 }
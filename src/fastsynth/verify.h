@@ -6,6 +6,8 @@
 
 #include <util/message.h>
 
+#include <memory>
+
 class decision_proceduret;
 
 /// verify a candidate solution
@@ -22,6 +24,8 @@ public:
   {
   }
 
+  ~verifyt();
+
   /// Check a new candidate.
   /// \return \see decision_proceduret::resultt
   virtual decision_proceduret::resultt operator()(const solutiont &);
@@ -34,13 +38,30 @@ public:
   bool use_smt;
   std::string logic;
 
+  /// SAT back end, see new_sat_solver().
+  std::string sat_solver;
+
 protected:
   const namespacet &ns;
   const problemt &problem;
   counterexamplet counterexample;
 
+  /// With use_smt, the solver process is kept across candidates.
+  std::unique_ptr<class smt2_processt> smt_process;
+
+  /// Checks a candidate with the given solver.
+  decision_proceduret::resultt solve(
+    const solutiont &,
+    decision_proceduret &);
+
   void add_problem(verify_encodingt &, decision_proceduret &);
 
+  /// Adds the side conditions and the negation of the given constraints.
+  void add_problem(
+    verify_encodingt &,
+    decision_proceduret &,
+    const exprt::operandst &constraints);
+
   void output(
     const solutiont::functionst &,
     std::ostream &);
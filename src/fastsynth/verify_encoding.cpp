@@ -65,46 +65,73 @@ void verify_encodingt::check_function_body(
   }
 }
 
+void verify_encodingt::setup() const
+{
+  if (cached_functions == functions && !f_map.empty())
+    return;
+
+  cached_functions = functions;
+  encoded.clear();
+  f_map.clear();
+
+  for (const auto &f : functions)
+    f_map[f.first.get_identifier()] = f.second;
+}
+
 exprt verify_encodingt::operator()(const exprt &expr) const
 {
+  setup();
+  return encode(expr);
+}
+
+exprt verify_encodingt::encode(const exprt &expr) const
+{
+  if (!expr.has_operands())
+    return expr;
+
+  const auto e_it = encoded.find(expr);
+  if (e_it != encoded.end())
+    return e_it->second;
+
+  exprt result;
+
   if (expr.id() == ID_function_application)
   {
     const auto &e = to_function_application_expr(expr);
 
-#if 0
-    auto f_it=functions.find(e.function());
-    
-    exprt result=f_it==functions.end()?
-      from_integer(0, e.type()):f_it->second;
-#endif
-
-    std::map<irep_idt, exprt> f_map;
-    for (const auto &f : functions)
-      f_map[f.first.get_identifier()] = f.second;
-
     auto f_it = f_map.find(to_symbol_expr(e.function()).get_identifier());
 
-    exprt result = f_it == f_map.end() ? from_integer(0, e.type()) : f_it->second;
+    const exprt body =
+        f_it == f_map.end() ? from_integer(0, e.type()) : f_it->second;
 
     // need to instantiate parameters with arguments
-    exprt instance = instantiate(result, e);
-
-    return instance;
+    instancest instances;
+    result = instantiate(body, e, instances);
   }
   else
   {
-    exprt tmp = expr;
+    result = expr;
 
-    for (auto &op : tmp.operands())
-      op = (*this)(op);
+    // unchanged operands stay shared with the input
+    for (std::size_t i = 0; i < expr.operands().size(); i++)
+    {
+      const exprt &op = expr.operands()[i];
+      exprt encoded_op = encode(op);
 
-    return tmp;
+      if (encoded_op != op)
+        result.operands()[i] = std::move(encoded_op);
+    }
   }
+
+  encoded.emplace(expr, result);
+
+  return result;
 }
 
 exprt verify_encodingt::instantiate(
     const exprt &expr,
-    const function_application_exprt &e) const
+    const function_application_exprt &e,
+    instancest &instances) const
 {
   if (expr.id() == ID_symbol)
   {
@@ -121,15 +148,27 @@ exprt verify_encodingt::instantiate(
     else
       return expr;
   }
-  else
-  {
-    exprt tmp = expr;
+  else if (!expr.has_operands())
+    return expr;
+
+  const auto i_it = instances.find(expr);
+  if (i_it != instances.end())
+    return i_it->second;
+
+  exprt tmp = expr;
 
-    for (auto &op : tmp.operands())
-      op = instantiate(op, e);
+  for (std::size_t i = 0; i < expr.operands().size(); i++)
+  {
+    const exprt &op = expr.operands()[i];
+    exprt instance = instantiate(op, e, instances);
 
-    return tmp;
+    if (instance != op)
+      tmp.operands()[i] = std::move(instance);
   }
+
+  instances.emplace(expr, tmp);
+
+  return tmp;
 }
 
 #include <iostream>
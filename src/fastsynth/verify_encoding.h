@@ -2,7 +2,9 @@
 #define CPROVER_FASTSYNTH_VERIFY_ENCODING_H_
 
 #include <set>
+#include <unordered_map>
 
+#include <util/irep_hash.h>
 #include <util/mathematical_expr.h>
 #include <util/mathematical_types.h>
 
@@ -31,9 +33,29 @@ public:
   static void check_function_bodies(const functionst &);
 
 protected:
+  /// The functions the caches below were built for.
+  mutable functionst cached_functions;
+
+  /// Function bodies by identifier.
+  mutable std::map<irep_idt, exprt> f_map;
+
+  /// Encoded expressions, so that subexpressions shared in the input,
+  /// and applications to the same arguments, share their encoding.
+  mutable std::unordered_map<exprt, exprt, irep_hash> encoded;
+
+  using instancest = std::unordered_map<exprt, exprt, irep_hash>;
+
+  /// Rebuilds f_map if the functions have changed.
+  void setup() const;
+
+  exprt encode(const exprt &) const;
+
+  /// Substitutes the arguments of \p e for the parameters in \p expr.
+  /// \param instances Subexpressions of the body instantiated so far.
   exprt instantiate(
     const exprt &expr,
-    const function_application_exprt &e) const;
+    const function_application_exprt &e,
+    instancest &instances) const;
 };
 
 #endif /* CPROVER_FASTSYNTH_VERIFY_ENCODING_H_ */